@@ -0,0 +1,842 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "application/arp-transport.h"
+#include "application/options.h"
+#include "application/probe-tracker.h"
+#include "application/result.h"
+#include "arp-sweep.h"
+#include "middleware/arp-frame.h"
+#include "middleware/cli.h"
+#include "middleware/ip-addr.h"
+#include "middleware/mac-addr.h"
+#include "middleware/net-if.h"
+#include "middleware/pacer.h"
+#include "middleware/rtt-estimator.h"
+#include "project.h"
+
+#include <omw/cli.h>
+#include <omw/clock.h>
+
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+
+
+using omw::clock::timepoint_t;
+using std::cout;
+using std::endl;
+
+
+
+namespace {
+
+constexpr timepoint_t initialTimeout_us = 1000000; // time to wait for a reply until the first RTT has been measured
+constexpr timepoint_t minTimeout_us = 50000;
+constexpr timepoint_t maxTimeout_us = 3000000;
+constexpr size_t txBurst = 64; // max number of requests sent between two receive calls
+constexpr size_t maxPending = 65536; // max number of targets per interface waiting for a reply
+constexpr int stallRetry_ms = 10; // poll timeout while the targets are stalled
+
+/**
+ * Returns the fanout shard which sends to and receives from `addr`, the fanout filter computes the same from the sender
+ * address of the replies.
+ */
+size_t shardOf(const ip::Addr4& addr, size_t count) { return (addr.value() % count); }
+
+/**
+ * @brief Opens the transports of all fanout shards for an interface at once.
+ *
+ * The fanout group hands a frame to the socket at the index which the filter returns, and the index is the order in which
+ * the sockets have joined. So the sockets of an interface are opened in shard order by the shard which needs the
+ * interface first, and each shard takes its own.
+ */
+class FanoutPool
+{
+public:
+    FanoutPool(size_t count, const app::Options& options)
+        : m_count(count), m_options(options), m_mtx(), m_groups()
+    {}
+
+    virtual ~FanoutPool() {}
+
+    FanoutPool(const FanoutPool& other) = delete;
+    FanoutPool& operator=(const FanoutPool& other) = delete;
+
+    /**
+     * Returns `nullptr` if the sockets of the interface could not be opened, the error has been printed once.
+     */
+    std::unique_ptr<app::ArpTransport> take(const netif::Interface& iface, size_t shard);
+
+private:
+    size_t m_count;
+    const app::Options& m_options;
+    std::mutex m_mtx;
+    std::map<int, std::vector<std::unique_ptr<app::ArpTransport>>> m_groups; // by interface index
+};
+
+/**
+ * @brief Sweep state of one interface.
+ */
+class Session
+{
+public:
+    explicit Session(const netif::Interface& iface)
+        : m_iface(iface),
+          m_transport(),
+          m_txBurst(txBurst),
+          m_queue(),
+          m_tracker(initialTimeout_us, minTimeout_us, maxTimeout_us),
+          m_txBlocked(false),
+          m_probeCount(0)
+    {}
+
+    virtual ~Session() {}
+
+    Session(const Session& other) = delete;
+    Session& operator=(const Session& other) = delete;
+
+    const netif::Interface& iface() const { return m_iface; }
+    bool isOpen() const { return (m_transport != nullptr); }
+    int fd() const { return (m_transport ? m_transport->fd() : -1); }
+
+    void addTarget(const ip::Addr4& addr) { m_queue.push_back(addr); }
+
+    /**
+     * Returns `true` if no more targets should be added until some have been sent or have replied.
+     */
+    bool full() const { return ((m_queue.size() >= m_txBurst) || (m_tracker.size() >= maxPending)); }
+
+    bool active() const { return (!m_queue.empty() || !m_tracker.empty()); }
+    bool txReady() const { return (!m_queue.empty() && !m_txBlocked && (m_tracker.size() < maxPending)); }
+    bool txBlocked() const { return m_txBlocked; }
+
+    size_t probeCount() const { return m_probeCount; } ///< number of requests sent, including retransmissions
+    size_t syscallCount() const { return m_transport->syscallCount(); }
+    const app::ProbeTracker& tracker() const { return m_tracker; }
+
+    /**
+     * Returns the time of the next retransmission or timeout, `-1` if there is none.
+     */
+    timepoint_t nextDeadline() const { return m_tracker.nextDeadline(); }
+
+    /**
+     * The transport is taken from `pool` if it's not `nullptr`.
+     */
+    int open(const app::Options& options, FanoutPool* pool, size_t shard);
+
+    /**
+     * The targets which have been answered, have timed out or have been skipped are reported to `targets` as finished.
+     */
+    void transmit(timepoint_t now, Pacer& pacer, app::TargetGenerator& targets);
+    void expire(timepoint_t now, Pacer& pacer, app::TargetGenerator& targets);
+    void receive(const app::ResultHandler& handler, app::TargetGenerator& targets);
+
+private:
+    netif::Interface m_iface;
+    std::unique_ptr<app::ArpTransport> m_transport;
+    size_t m_txBurst;
+
+    std::deque<ip::Addr4> m_queue; // targets which haven't been sent to yet
+
+    app::ProbeTracker m_tracker;
+
+    bool m_txBlocked;
+    size_t m_probeCount;
+
+    app::ArpTransport::TxStatus send(const ip::Addr4& addr);
+};
+
+/**
+ * @brief One sweep loop, with a session per interface. Each fanout shard runs its own on its own thread.
+ */
+struct Shard
+{
+    std::vector<std::unique_ptr<Session>> sessions;
+    size_t pollCount = 0;
+    size_t offSubnet = 0;
+};
+
+/**
+ * @brief Passes the targets from the main thread to the fanout shards, and their results and finished targets back.
+ *
+ * The targets are passed in chunks, so that the lock is taken once per chunk and not once per target. The number of
+ * chunks per shard is bounded, the main thread stops generating while a shard is behind. The results are printed by the
+ * main thread, as in a sweep without fanout.
+ */
+class Dispatcher
+{
+public:
+    using chunk_type = std::vector<ip::Addr4>;
+
+    static constexpr size_t chunk_size = 64;
+    static constexpr size_t max_chunks = 64; // per shard
+
+public:
+    explicit Dispatcher(size_t shardCount)
+        : m_chunks(shardCount), m_closed(false), m_failed(false), m_running(shardCount), m_results(), m_finished(), m_mtx(), m_mainCv(), m_mainSignal(false)
+    {}
+
+    virtual ~Dispatcher() {}
+
+    Dispatcher(const Dispatcher& other) = delete;
+    Dispatcher& operator=(const Dispatcher& other) = delete;
+
+public: // main thread
+    /**
+     * Moves `chunk` to the queue of `shard`. Returns `false` and leaves `chunk` untouched if the queue is full.
+     */
+    bool push(size_t shard, chunk_type& chunk);
+
+    /**
+     * No more targets, the shards finish when their queues are empty.
+     */
+    void close();
+
+    /**
+     * Blocks until a chunk has been taken, a result has been posted or a shard has finished.
+     */
+    void wait();
+
+    /**
+     * Calls `handler` for the results posted since the last call, and reports the targets posted as finished to
+     * `targets` afterwards.
+     */
+    void drain(const app::ResultHandler& handler, app::TargetGenerator& targets);
+
+    bool done() const;
+    bool failed() const;
+
+public: // shard threads
+    /**
+     * Takes the next chunk of `shard` without blocking, the shard keeps serving its probes in flight while the main
+     * thread is behind. Returns `false` if the queue is empty, `stalled` is set if more chunks may follow.
+     */
+    bool tryPop(size_t shard, chunk_type& chunk, bool& stalled);
+
+    void post(const app::ScanResult& result);
+    void postFinished(const ip::Addr4& addr);
+    void finish(bool failed);
+
+private:
+    std::vector<std::deque<chunk_type>> m_chunks;
+    bool m_closed;
+    bool m_failed;
+    size_t m_running;
+    std::vector<app::ScanResult> m_results;
+    std::vector<ip::Addr4> m_finished;
+    mutable std::mutex m_mtx;
+    std::condition_variable m_mainCv;
+    bool m_mainSignal; // set with every notification of `m_mainCv`
+};
+
+/**
+ * @brief The targets of one shard, as they're passed by the dispatcher.
+ */
+class ShardTargets : public app::TargetGenerator
+{
+public:
+    ShardTargets(Dispatcher& dispatcher, size_t shard)
+        : m_dispatcher(dispatcher), m_shard(shard), m_chunk(), m_next(0), m_stalled(false)
+    {}
+
+    virtual ~ShardTargets() {}
+
+    ShardTargets(const ShardTargets& other) = delete;
+    ShardTargets& operator=(const ShardTargets& other) = delete;
+
+    virtual bool next(ip::Addr4& addr);
+    virtual bool stalled() const { return m_stalled; }
+    virtual void finished(const ip::Addr4& addr) { m_dispatcher.postFinished(addr); }
+    virtual size_t size() const { return unknown_size; }
+
+private:
+    Dispatcher& m_dispatcher;
+    size_t m_shard;
+    Dispatcher::chunk_type m_chunk;
+    size_t m_next;
+    bool m_stalled;
+};
+
+} // namespace
+
+
+
+static int sweep(Shard& shard, app::TargetGenerator& targets, const app::ResultHandler& handler, const app::Options& options, FanoutPool* pool, size_t index);
+static int fanoutSweep(std::vector<Shard>& shards, app::TargetGenerator& targets, const app::ResultHandler& handler, const app::Options& options);
+static void pinToCpu(std::thread& th, size_t index);
+static void printStats(const std::vector<Shard>& shards);
+
+
+
+int app::arpSweep(app::TargetGenerator& targets, const app::ResultHandler& handler, const app::Options& options)
+{
+    std::vector<Shard> shards(options.fanout());
+
+    int err;
+    if (shards.size() > 1) { err = fanoutSweep(shards, targets, handler, options); }
+    else { err = sweep(shards[0], targets, handler, options, nullptr, 0); }
+    if (err) { return -(__LINE__); }
+
+    size_t offSubnet = 0;
+    for (const auto& shard : shards) { offSubnet += shard.offSubnet; }
+
+    if (offSubnet > 0) { cli::printWarning(std::to_string(offSubnet) + " addresses are not on a local subnet and are skipped"); }
+
+    if (options.stats()) { printStats(shards); }
+
+    return 0;
+}
+
+
+
+int sweep(Shard& shard, app::TargetGenerator& targets, const app::ResultHandler& handler, const app::Options& options, FanoutPool* pool, size_t index)
+{
+    auto& sessions = shard.sessions;
+
+    const auto interfaces = netif::getInterfaces();
+
+    sessions.reserve(interfaces.size());
+    for (const auto& iface : interfaces) { sessions.push_back(std::make_unique<Session>(iface)); }
+
+    ip::Addr4 next;
+    bool more = targets.next(next); // `next` is the next target to assign
+    bool stalled = (!more && targets.stalled()); // no target available yet, more will follow
+
+    const auto pull = [&]() {
+        more = targets.next(next);
+        stalled = (!more && targets.stalled());
+    };
+
+    // assigns the targets to the sessions of their interfaces, only as many as can be sent soon, so that the targets are
+    // never held in memory
+    const auto assign = [&]() {
+        if (stalled) { pull(); }
+
+        while (more)
+        {
+            Session* session = nullptr;
+            for (size_t i = 0; (i < sessions.size()) && !session; ++i)
+            {
+                if (sessions[i]->iface().contains(next)) { session = sessions[i].get(); }
+            }
+
+            if (session)
+            {
+                // the sockets are opened on demand, only for the interfaces which have targets
+                if (!session->isOpen())
+                {
+                    const int err = session->open(options, pool, index);
+                    if (err) { return -(__LINE__); }
+                }
+
+                if (session->full()) { break; }
+
+                session->addTarget(next);
+            }
+            else
+            {
+                ++shard.offSubnet;
+                targets.finished(next);
+            }
+
+            pull();
+        }
+
+        return 0;
+    };
+
+    // the shards share the rate exactly, the first `rate % shardCount` ones send one probe per second more
+    const uint32_t shardCount = (uint32_t)options.fanout();
+    const uint32_t rate = (options.rate() / shardCount) + ((index < (options.rate() % shardCount)) ? 1 : 0);
+    if ((options.rate() > 0) && (rate == 0)) { return -(__LINE__); } // 0 would be unlimited, rejected by the option parser
+
+    Pacer pacer;
+    if (pacer.open(rate, options.burst())) { return -(__LINE__); }
+
+
+
+    if (assign()) { return -(__LINE__); }
+
+    std::vector<struct pollfd> pfds(sessions.size() + 1); // the last one is the pacing timer
+
+    while (more || stalled || std::any_of(sessions.begin(), sessions.end(), [](const std::unique_ptr<Session>& s) { return s->active(); }))
+    {
+        timepoint_t now = omw::clock::now();
+
+        for (const auto& s : sessions)
+        {
+            s->expire(now, pacer, targets);
+            s->transmit(now, pacer, targets);
+        }
+
+        // refill the queues, so that the next burst is ready when the poll timeout is computed
+        if (assign()) { return -(__LINE__); }
+
+        // compute the poll timeout
+        int timeout_ms = 100;
+        bool paced = false;
+        for (size_t i = 0; i < sessions.size(); ++i)
+        {
+            const auto& s = sessions[i];
+
+            if (s->txReady())
+            {
+                if (pacer.ready(now)) { timeout_ms = 0; }
+                else { paced = true; }
+            }
+            else if (s->txBlocked()) { timeout_ms = std::min(timeout_ms, 1); }
+
+            const timepoint_t deadline = s->nextDeadline();
+            if (deadline >= 0)
+            {
+                const timepoint_t dt = (deadline > now ? deadline - now : 0);
+                timeout_ms = std::min(timeout_ms, (int)((dt + 999) / 1000));
+            }
+
+            pfds[i].fd = s->fd();
+            pfds[i].events = POLLIN | (s->txBlocked() ? POLLOUT : 0);
+            pfds[i].revents = 0;
+        }
+
+        if (stalled) { timeout_ms = std::min(timeout_ms, stallRetry_ms); }
+
+        // the timer wakes the loop up when the next request may be sent
+        if (paced) { pacer.arm(now); }
+        pfds.back().fd = (paced ? pacer.fd() : -1);
+        pfds.back().events = POLLIN;
+        pfds.back().revents = 0;
+
+        ++shard.pollCount;
+        const int n = poll(pfds.data(), pfds.size(), timeout_ms);
+        if ((n < 0) && (errno != EINTR))
+        {
+            cli::printError("poll() failed", std::strerror(errno));
+            return -(__LINE__);
+        }
+
+        for (size_t i = 0; (n > 0) && (i < sessions.size()); ++i)
+        {
+            if (pfds[i].revents & POLLIN) { sessions[i]->receive(handler, targets); }
+        }
+
+        if ((n > 0) && (pfds.back().revents & POLLIN)) { pacer.acknowledge(); }
+    }
+
+    return 0;
+}
+
+int fanoutSweep(std::vector<Shard>& shards, app::TargetGenerator& targets, const app::ResultHandler& handler, const app::Options& options)
+{
+    const size_t count = shards.size();
+
+    FanoutPool pool(count, options);
+    Dispatcher dispatcher(count);
+
+    std::vector<std::thread> threads(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        threads[i] = std::thread([&, i]() {
+            ShardTargets shardTargets(dispatcher, i);
+            const int err = sweep(shards[i], shardTargets, [&](const app::ScanResult& result) { dispatcher.post(result); }, options, &pool, i);
+            dispatcher.finish(err != 0);
+        });
+
+        pinToCpu(threads[i], i);
+    }
+
+    // hands the chunk of `shard` over, while the results are printed
+    const auto push = [&](size_t shard, Dispatcher::chunk_type& chunk) {
+        while (!dispatcher.push(shard, chunk) && !dispatcher.failed())
+        {
+            dispatcher.drain(handler, targets);
+            dispatcher.wait();
+        }
+    };
+
+    std::vector<Dispatcher::chunk_type> chunks(count);
+    ip::Addr4 addr;
+
+    while (!dispatcher.failed())
+    {
+        if (!targets.next(addr))
+        {
+            if (!targets.stalled()) { break; }
+
+            // the collected targets are handed over and the results printed until more targets are available
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (!chunks[i].empty()) { push(i, chunks[i]); }
+            }
+
+            dispatcher.drain(handler, targets);
+            std::this_thread::sleep_for(std::chrono::milliseconds(stallRetry_ms));
+            continue;
+        }
+
+        const size_t shard = shardOf(addr, count);
+
+        chunks[shard].push_back(addr);
+        if (chunks[shard].size() >= Dispatcher::chunk_size)
+        {
+            push(shard, chunks[shard]);
+            dispatcher.drain(handler, targets);
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (!chunks[i].empty()) { push(i, chunks[i]); }
+    }
+
+    dispatcher.close();
+
+    while (!dispatcher.done())
+    {
+        dispatcher.drain(handler, targets);
+        dispatcher.wait();
+    }
+
+    dispatcher.drain(handler, targets);
+
+    for (auto& th : threads) { th.join(); }
+
+    return (dispatcher.failed() ? -(__LINE__) : 0);
+}
+
+
+
+std::unique_ptr<app::ArpTransport> FanoutPool::take(const netif::Interface& iface, size_t shard)
+{
+    std::lock_guard<std::mutex> lg(m_mtx);
+
+    auto it = m_groups.find(iface.index());
+    if (it == m_groups.end())
+    {
+        std::vector<std::unique_ptr<app::ArpTransport>> group(m_count);
+
+        uint16_t groupId = 0;
+        for (size_t i = 0; i < m_count; ++i)
+        {
+            auto transport = app::ArpTransport::create(m_options);
+            if (transport->open(iface) || transport->joinFanout(groupId))
+            {
+                // the sockets which have joined leave the group when they're closed
+                for (auto& t : group) { t.reset(); }
+                break;
+            }
+
+            group[i] = std::move(transport);
+        }
+
+        it = m_groups.emplace(iface.index(), std::move(group)).first;
+    }
+
+    return std::move(it->second[shard]);
+}
+
+int Session::open(const app::Options& options, FanoutPool* pool, size_t shard)
+{
+    // a burst fills at least one batch, otherwise the batches would be flushed half empty
+    if (options.arpIo() == app::ArpIo::batch) { m_txBurst = std::max(txBurst, options.batchSize()); }
+
+    if (pool)
+    {
+        m_transport = pool->take(m_iface, shard);
+        if (!m_transport) { return -(__LINE__); }
+    }
+    else
+    {
+        m_transport = app::ArpTransport::create(options);
+
+        const int err = m_transport->open(m_iface);
+        if (err) { return -(__LINE__); }
+    }
+
+    return 0;
+}
+
+void Session::transmit(timepoint_t now, Pacer& pacer, app::TargetGenerator& targets)
+{
+    m_txBlocked = false;
+
+    if (!this->isOpen()) { return; }
+
+    for (size_t i = 0; (i < m_txBurst) && !m_queue.empty() && (m_tracker.size() < maxPending) && pacer.ready(now); ++i)
+    {
+        const ip::Addr4 addr = m_queue.front();
+
+        const auto status = this->send(addr);
+        if (status == app::ArpTransport::TxStatus::busy) { break; }
+
+        // on failure the error has been printed and the target is skipped
+        if (status == app::ArpTransport::TxStatus::sent)
+        {
+            pacer.consume();
+            m_tracker.sent(addr, now);
+        }
+        else { targets.finished(addr); }
+
+        m_queue.pop_front();
+    }
+
+    m_transport->flush();
+}
+
+void Session::expire(timepoint_t now, Pacer& pacer, app::TargetGenerator& targets)
+{
+    if (!this->isOpen()) { return; }
+
+    // retransmissions are not held back, they delay the following new requests instead
+    m_tracker.expire(
+        now,
+        [&](const ip::Addr4& addr) {
+            const app::ArpTransport::TxStatus status = this->send(addr);
+
+            if (status == app::ArpTransport::TxStatus::sent)
+            {
+                pacer.consume();
+                return app::ProbeTracker::TxResult::sent;
+            }
+
+            return (status == app::ArpTransport::TxStatus::busy ? app::ProbeTracker::TxResult::busy : app::ProbeTracker::TxResult::failed);
+        },
+        [&](const ip::Addr4& addr) { targets.finished(addr); });
+
+    m_transport->flush();
+}
+
+void Session::receive(const app::ResultHandler& handler, app::TargetGenerator& targets)
+{
+    m_transport->receive([&](const uint8_t* frame, size_t size, timepoint_t rxTime) {
+        mac::Addr sha;
+        ip::Addr4 spa, tpa;
+        if (!arp::parseReply(frame, size, sha, spa, tpa)) { return; }
+
+        timepoint_t rtt_us;
+        if (!m_tracker.replied(spa, rxTime, rtt_us)) { return; } // not a target, or already answered
+
+        handler(app::ScanResult(spa, sha, (uint32_t)((rtt_us + 500) / 1000), app::Vendor()));
+        targets.finished(spa);
+    });
+}
+
+app::ArpTransport::TxStatus Session::send(const ip::Addr4& addr)
+{
+    const auto status = m_transport->send(addr);
+    if (status == app::ArpTransport::TxStatus::busy) { m_txBlocked = true; }
+    else if (status == app::ArpTransport::TxStatus::sent) { ++m_probeCount; }
+    return status;
+}
+
+bool Dispatcher::push(size_t shard, chunk_type& chunk)
+{
+    {
+        std::lock_guard<std::mutex> lg(m_mtx);
+        if (m_chunks[shard].size() >= max_chunks) { return false; }
+        m_chunks[shard].push_back(std::move(chunk));
+    }
+
+    chunk.clear();
+
+    return true;
+}
+
+void Dispatcher::close()
+{
+    std::lock_guard<std::mutex> lg(m_mtx);
+    m_closed = true;
+}
+
+void Dispatcher::wait()
+{
+    // the timeout is a safety net only, every state change notifies
+    std::unique_lock<std::mutex> lock(m_mtx);
+    m_mainCv.wait_for(lock, std::chrono::milliseconds(100), [&]() { return m_mainSignal; });
+    m_mainSignal = false;
+}
+
+void Dispatcher::drain(const app::ResultHandler& handler, app::TargetGenerator& targets)
+{
+    std::vector<app::ScanResult> results;
+    std::vector<ip::Addr4> finished;
+
+    // taken together, a target is always posted as finished after its results
+    {
+        std::lock_guard<std::mutex> lg(m_mtx);
+        results.swap(m_results);
+        finished.swap(m_finished);
+    }
+
+    for (const auto& result : results) { handler(result); }
+    for (const auto& addr : finished) { targets.finished(addr); }
+}
+
+bool Dispatcher::done() const
+{
+    std::lock_guard<std::mutex> lg(m_mtx);
+    return ((m_running == 0) && m_results.empty() && m_finished.empty());
+}
+
+bool Dispatcher::failed() const
+{
+    std::lock_guard<std::mutex> lg(m_mtx);
+    return m_failed;
+}
+
+bool Dispatcher::tryPop(size_t shard, chunk_type& chunk, bool& stalled)
+{
+    auto& queue = m_chunks[shard];
+
+    {
+        std::lock_guard<std::mutex> lg(m_mtx);
+
+        // a failed shard doesn't take its targets anymore, the other shards stop too
+        stalled = (queue.empty() && !m_closed && !m_failed);
+        if (queue.empty() || m_failed) { return false; }
+
+        chunk = std::move(queue.front());
+        queue.pop_front();
+        m_mainSignal = true;
+    }
+
+    // the main thread may be waiting for room in this queue
+    m_mainCv.notify_one();
+
+    return true;
+}
+
+void Dispatcher::post(const app::ScanResult& result)
+{
+    {
+        std::lock_guard<std::mutex> lg(m_mtx);
+        m_results.push_back(result);
+        m_mainSignal = true;
+    }
+
+    m_mainCv.notify_one();
+}
+
+void Dispatcher::postFinished(const ip::Addr4& addr)
+{
+    // every target finishes, the main thread isn't woken up for them but picks them up with the next results or chunk
+    std::lock_guard<std::mutex> lg(m_mtx);
+    m_finished.push_back(addr);
+}
+
+void Dispatcher::finish(bool failed)
+{
+    {
+        std::lock_guard<std::mutex> lg(m_mtx);
+        --m_running;
+        if (failed) { m_failed = true; }
+        m_mainSignal = true;
+    }
+
+    m_mainCv.notify_one();
+}
+
+bool ShardTargets::next(ip::Addr4& addr)
+{
+    if (m_next >= m_chunk.size())
+    {
+        if (!m_dispatcher.tryPop(m_shard, m_chunk, m_stalled)) { return false; }
+        m_next = 0;
+    }
+
+    addr = m_chunk[m_next++];
+
+    return true;
+}
+
+void pinToCpu(std::thread& th, size_t index)
+{
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) { return; }
+
+    const size_t cpuCount = (size_t)CPU_COUNT(&allowed);
+    if (cpuCount == 0) { return; }
+
+    // the n-th allowed CPU, round robin if there are more shards than CPUs
+    size_t n = index % cpuCount;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+        if (!CPU_ISSET(cpu, &allowed)) { continue; }
+
+        if (n == 0)
+        {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            (void)pthread_setaffinity_np(th.native_handle(), sizeof(set), &set);
+            break;
+        }
+
+        --n;
+    }
+}
+
+void printStats(const std::vector<Shard>& shards)
+{
+    size_t probes = 0;
+    size_t pollCount = 0;
+    size_t syscalls = 0;
+
+    const auto toMs = [](timepoint_t t_us) {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(2) << ((double)t_us / 1000.0);
+        return ss.str();
+    };
+
+    cout << omw::fgBrightBlack;
+
+    for (size_t i = 0; i < shards.size(); ++i)
+    {
+        pollCount += shards[i].pollCount;
+
+        for (const auto& s : shards[i].sessions)
+        {
+            if (!s->isOpen()) { continue; } // no targets on this interface
+
+            probes += s->probeCount();
+            syscalls += s->syscallCount();
+
+            const app::ProbeTracker& tracker = s->tracker();
+            const RttEstimator& rtt = tracker.rtt();
+
+            if (shards.size() > 1) { cout << "shard " << (i + 1) << "/" << shards.size() << " "; }
+            cout << s->iface().name() << " " << ip::cidrString(s->iface().network(), s->iface().mask()) << ": ";
+            if (rtt.sampleCount() > 0) { cout << "srtt " << toMs(rtt.srtt()) << "ms, rttvar " << toMs(rtt.rttvar()) << "ms, "; }
+            cout << "timeout " << toMs(rtt.rto()) << "ms, " << tracker.requestCount() << " requests per target, ";
+            cout << rtt.sampleCount() << " samples, " << tracker.lateReplyCount() << "/" << tracker.replyCount() << " replies after retransmission" << endl;
+        }
+    }
+
+    syscalls += pollCount;
+
+    cout << "probes: " << probes << ", syscalls: " << syscalls << " (" << pollCount << " poll)";
+    if (probes > 0) { cout << ", " << ((syscalls * 1000 + probes / 2) / probes) << " syscalls per 1k probes"; }
+    cout << omw::fgDefault << endl;
+}
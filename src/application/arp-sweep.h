@@ -0,0 +1,34 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_APPLICATION_ARPSWEEP_H
+#define IG_APPLICATION_ARPSWEEP_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "application/options.h"
+#include "application/result.h"
+#include "application/targets.h"
+#include "middleware/ip-addr.h"
+
+
+namespace app {
+
+/**
+ * Scans the addresses generated by `targets` by ARP. One `AF_PACKET` socket is opened per local interface, the requests
+ * for all targets on that interface's subnet are sent back to back and the replies are matched to the targets as they
+ * arrive. `handler` is called once for every host that replied. Addresses which are not on a local subnet are skipped.
+ * The socket I/O is selected by `options.arpIo()`.
+ *
+ * Requires `CAP_NET_RAW`. Blocks until every target has replied or timed out, returns 0 on success.
+ */
+int arpSweep(app::TargetGenerator& targets, const app::ResultHandler& handler, const app::Options& options);
+
+} // namespace app
+
+
+#endif // IG_APPLICATION_ARPSWEEP_H
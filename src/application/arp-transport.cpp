@@ -0,0 +1,408 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "application/options.h"
+#include "arp-transport.h"
+#include "middleware/arp-frame.h"
+#include "middleware/cli.h"
+#include "middleware/ip-addr.h"
+#include "middleware/net-if.h"
+#include "middleware/packet-ring.h"
+
+#include <omw/clock.h>
+
+#include <arpa/inet.h>
+#include <linux/filter.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+
+
+namespace {
+
+constexpr int socketBufferSize = 4 * 1024 * 1024;
+
+/**
+ * @brief One `send()` and `recv()` per frame.
+ */
+class SocketTransport : public app::ArpTransport
+{
+public:
+    SocketTransport()
+        : m_ifName(), m_fd(-1), m_syscalls(0)
+    {}
+
+    virtual ~SocketTransport()
+    {
+        if (m_fd >= 0) { close(m_fd); }
+    }
+
+    virtual int open(const netif::Interface& iface);
+    virtual int fd() const { return m_fd; }
+    virtual TxStatus send(const ip::Addr4& tpa);
+    virtual void flush() {}
+    virtual void receive(const frame_handler& handler);
+    virtual size_t syscallCount() const { return m_syscalls; }
+
+protected:
+    std::string m_ifName;
+    int m_fd;
+    size_t m_syscalls;
+    uint8_t m_frame[arp::frame_size];
+};
+
+/**
+ * @brief Sends and receives up to `batchSize` frames per `sendmmsg()`/`recvmmsg()`.
+ */
+class BatchTransport : public SocketTransport
+{
+public:
+    explicit BatchTransport(size_t batchSize);
+    virtual ~BatchTransport() {}
+
+    virtual int open(const netif::Interface& iface);
+    virtual TxStatus send(const ip::Addr4& tpa);
+    virtual void flush();
+    virtual void receive(const frame_handler& handler);
+
+private:
+    static constexpr size_t rx_buffer_size = 128;
+
+    size_t m_batchSize;
+
+    std::vector<uint8_t> m_txFrames; // `m_batchSize` templated frames
+    std::vector<struct iovec> m_txIov;
+    std::vector<struct mmsghdr> m_txMsg;
+    size_t m_txQueued;
+
+    std::vector<uint8_t> m_rxBuffer;
+    std::vector<struct iovec> m_rxIov;
+    std::vector<struct mmsghdr> m_rxMsg;
+
+    uint8_t* txFrame(size_t idx) { return (m_txFrames.data() + idx * arp::frame_size); }
+};
+
+/**
+ * @brief PACKET_MMAP TX and RX rings. Every TX frame is templated once, only the target IP is patched before it's
+ * submitted.
+ */
+class RingTransport : public app::ArpTransport
+{
+public:
+    RingTransport()
+        : m_ring(), m_txNext(0), m_txPending(0), m_syscalls(0)
+    {}
+
+    virtual ~RingTransport() {}
+
+    virtual int open(const netif::Interface& iface);
+    virtual int fd() const { return m_ring.fd(); }
+    virtual TxStatus send(const ip::Addr4& tpa);
+    virtual void flush();
+    virtual void receive(const frame_handler& handler) { m_ring.receive(handler); }
+    virtual size_t syscallCount() const { return m_syscalls; }
+
+private:
+    PacketRing m_ring;
+    size_t m_txNext;
+    size_t m_txPending; // submitted but not yet flushed
+    size_t m_syscalls;
+};
+
+} // namespace
+
+
+
+std::unique_ptr<app::ArpTransport> app::ArpTransport::create(const app::Options& options)
+{
+    std::unique_ptr<app::ArpTransport> transport;
+
+    switch (options.arpIo())
+    {
+    case app::ArpIo::socket:
+        transport = std::make_unique<SocketTransport>();
+        break;
+
+    case app::ArpIo::batch:
+        transport = std::make_unique<BatchTransport>(options.batchSize());
+        break;
+
+    case app::ArpIo::ring:
+        transport = std::make_unique<RingTransport>();
+        break;
+    }
+
+    return transport;
+}
+
+int app::ArpTransport::joinFanout(uint16_t& group)
+{
+    const int fd = this->fd();
+    const bool create = (group == 0);
+
+    // the unique id flag lets the kernel pick an unused id, it isn't stored with the group
+    int arg = (int)group | ((PACKET_FANOUT_CBPF | (create ? PACKET_FANOUT_FLAG_UNIQUEID : 0)) << 16);
+    if (setsockopt(fd, SOL_PACKET, PACKET_FANOUT, &arg, sizeof(arg)) != 0)
+    {
+        cli::printError("failed to join PACKET_FANOUT group", std::strerror(errno));
+        return -(__LINE__);
+    }
+
+    if (create)
+    {
+        socklen_t len = sizeof(arg);
+        if (getsockopt(fd, SOL_PACKET, PACKET_FANOUT, &arg, &len) != 0)
+        {
+            cli::printError("failed to get the PACKET_FANOUT group id", std::strerror(errno));
+            return -(__LINE__);
+        }
+
+        group = (uint16_t)(arg & 0xFFFF);
+
+        // the filter is shared by the group, the kernel takes its result modulo the number of sockets
+        struct sock_filter code[] = {
+            BPF_STMT(BPF_LD | BPF_W | BPF_ABS, (uint32_t)(SKF_NET_OFF + arp::spa_offset - ETH_HLEN)),
+            BPF_STMT(BPF_RET | BPF_A, 0),
+        };
+
+        struct sock_fprog prog;
+        prog.len = sizeof(code) / sizeof(code[0]);
+        prog.filter = code;
+
+        if (setsockopt(fd, SOL_PACKET, PACKET_FANOUT_DATA, &prog, sizeof(prog)) != 0)
+        {
+            cli::printError("failed to set the PACKET_FANOUT filter", std::strerror(errno));
+            return -(__LINE__);
+        }
+    }
+
+    return 0;
+}
+
+
+
+int SocketTransport::open(const netif::Interface& iface)
+{
+    m_ifName = iface.name();
+    arp::buildRequest(m_frame, iface.mac(), iface.ip(), ip::Addr4::null);
+
+    m_fd = socket(AF_PACKET, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, htons(ETH_P_ARP));
+    if (m_fd < 0)
+    {
+        cli::printError("failed to open AF_PACKET socket on " + m_ifName, std::strerror(errno));
+        return -(__LINE__);
+    }
+
+    struct sockaddr_ll sll;
+    std::memset(&sll, 0, sizeof(sll));
+    sll.sll_family = AF_PACKET;
+    sll.sll_protocol = htons(ETH_P_ARP);
+    sll.sll_ifindex = iface.index();
+
+    if (bind(m_fd, (const struct sockaddr*)(&sll), sizeof(sll)) != 0)
+    {
+        cli::printError("failed to bind AF_PACKET socket to " + m_ifName, std::strerror(errno));
+        return -(__LINE__);
+    }
+
+    // a large buffer prevents dropping replies while the requests are sent at wire rate
+    const int bufSize = socketBufferSize;
+    (void)setsockopt(m_fd, SOL_SOCKET, SO_RCVBUF, &bufSize, sizeof(bufSize));
+
+    return 0;
+}
+
+app::ArpTransport::TxStatus SocketTransport::send(const ip::Addr4& tpa)
+{
+    arp::setTargetIP(m_frame, tpa);
+
+    ++m_syscalls;
+    if (::send(m_fd, m_frame, sizeof(m_frame), 0) < 0)
+    {
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == ENOBUFS)) { return TxStatus::busy; }
+
+        cli::printError("send() failed on " + m_ifName, std::strerror(errno));
+        return TxStatus::failed;
+    }
+
+    return TxStatus::sent;
+}
+
+void SocketTransport::receive(const frame_handler& handler)
+{
+    uint8_t buffer[256];
+
+    while (true)
+    {
+        ++m_syscalls;
+        const ssize_t n = recv(m_fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (n < 0)
+        {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)) { cli::printError("recv() failed on " + m_ifName, std::strerror(errno)); }
+            break;
+        }
+
+        handler(buffer, (size_t)n, omw::clock::now());
+    }
+}
+
+
+
+BatchTransport::BatchTransport(size_t batchSize)
+    : SocketTransport(),
+      m_batchSize(batchSize > 0 ? batchSize : 1),
+      m_txFrames(m_batchSize * arp::frame_size),
+      m_txIov(m_batchSize),
+      m_txMsg(m_batchSize),
+      m_txQueued(0),
+      m_rxBuffer(m_batchSize * rx_buffer_size),
+      m_rxIov(m_batchSize),
+      m_rxMsg(m_batchSize)
+{
+    for (size_t i = 0; i < m_batchSize; ++i)
+    {
+        m_txIov[i].iov_base = this->txFrame(i);
+        m_txIov[i].iov_len = arp::frame_size;
+        std::memset(&m_txMsg[i], 0, sizeof(m_txMsg[i]));
+        m_txMsg[i].msg_hdr.msg_iov = &m_txIov[i];
+        m_txMsg[i].msg_hdr.msg_iovlen = 1;
+
+        m_rxIov[i].iov_base = m_rxBuffer.data() + i * rx_buffer_size;
+        m_rxIov[i].iov_len = rx_buffer_size;
+        std::memset(&m_rxMsg[i], 0, sizeof(m_rxMsg[i]));
+        m_rxMsg[i].msg_hdr.msg_iov = &m_rxIov[i];
+        m_rxMsg[i].msg_hdr.msg_iovlen = 1;
+    }
+}
+
+int BatchTransport::open(const netif::Interface& iface)
+{
+    const int err = SocketTransport::open(iface);
+    if (err) { return -(__LINE__); }
+
+    for (size_t i = 0; i < m_batchSize; ++i) { arp::buildRequest(this->txFrame(i), iface.mac(), iface.ip(), ip::Addr4::null); }
+
+    return 0;
+}
+
+app::ArpTransport::TxStatus BatchTransport::send(const ip::Addr4& tpa)
+{
+    if (m_txQueued >= m_batchSize)
+    {
+        this->flush();
+        if (m_txQueued >= m_batchSize) { return TxStatus::busy; }
+    }
+
+    arp::setTargetIP(this->txFrame(m_txQueued), tpa);
+    ++m_txQueued;
+
+    if (m_txQueued >= m_batchSize) { this->flush(); }
+
+    return TxStatus::sent;
+}
+
+void BatchTransport::flush()
+{
+    if (m_txQueued == 0) { return; }
+
+    ++m_syscalls;
+    const int n = sendmmsg(m_fd, m_txMsg.data(), (unsigned int)m_txQueued, MSG_DONTWAIT);
+
+    if (n < 0)
+    {
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == ENOBUFS)) { return; } // stay queued
+
+        cli::printError("sendmmsg() failed on " + m_ifName, std::strerror(errno));
+        m_txQueued = 0;
+    }
+    else if ((size_t)n < m_txQueued)
+    {
+        // move the frames which have not been sent to the front, only the target IP differs
+        for (size_t i = (size_t)n; i < m_txQueued; ++i)
+        {
+            std::memcpy(this->txFrame(i - n) + arp::tpa_offset, this->txFrame(i) + arp::tpa_offset, ip::Addr4::octet_count);
+        }
+
+        m_txQueued -= (size_t)n;
+    }
+    else { m_txQueued = 0; }
+}
+
+void BatchTransport::receive(const frame_handler& handler)
+{
+    while (true)
+    {
+        ++m_syscalls;
+        const int n = recvmmsg(m_fd, m_rxMsg.data(), (unsigned int)m_batchSize, MSG_DONTWAIT, nullptr);
+        if (n < 0)
+        {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)) { cli::printError("recvmmsg() failed on " + m_ifName, std::strerror(errno)); }
+            break;
+        }
+
+        const auto now = omw::clock::now();
+
+        for (int i = 0; i < n; ++i) { handler((const uint8_t*)m_rxIov[i].iov_base, m_rxMsg[i].msg_len, now); }
+
+        if ((size_t)n < m_batchSize) { break; } // drained
+    }
+}
+
+
+
+int RingTransport::open(const netif::Interface& iface)
+{
+    const int err = m_ring.open(iface.index(), ETH_P_ARP);
+    if (err)
+    {
+        cli::printError("failed to open packet ring on " + iface.name());
+        return -(__LINE__);
+    }
+
+    static_assert(PacketRing::txFrameSize() >= arp::frame_size);
+
+    for (size_t i = 0; i < m_ring.txFrameCount(); ++i) { arp::buildRequest(m_ring.txData(i), iface.mac(), iface.ip(), ip::Addr4::null); }
+
+    return 0;
+}
+
+app::ArpTransport::TxStatus RingTransport::send(const ip::Addr4& tpa)
+{
+    if (!m_ring.txAvailable(m_txNext))
+    {
+        this->flush();
+        return TxStatus::busy;
+    }
+
+    arp::setTargetIP(m_ring.txData(m_txNext), tpa);
+    m_ring.txSubmit(m_txNext, arp::frame_size);
+
+    m_txNext = (m_txNext + 1) % m_ring.txFrameCount();
+    ++m_txPending;
+
+    return TxStatus::sent;
+}
+
+void RingTransport::flush()
+{
+    if (m_txPending > 0)
+    {
+        ++m_syscalls;
+        (void)m_ring.flush();
+        m_txPending = 0;
+    }
+}
@@ -0,0 +1,78 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_APPLICATION_ARPTRANSPORT_H
+#define IG_APPLICATION_ARPTRANSPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "application/options.h"
+#include "middleware/ip-addr.h"
+#include "middleware/net-if.h"
+#include "middleware/packet-ring.h"
+
+
+namespace app {
+
+/**
+ * @brief Interface class, sends ARP requests and receives frames on one interface.
+ */
+class ArpTransport
+{
+public:
+    using frame_handler = PacketRing::frame_handler;
+
+    enum class TxStatus
+    {
+        sent,
+        busy,   ///< TX buffer is full, try again later
+        failed, ///< the error has been printed
+    };
+
+public:
+    ArpTransport() {}
+    virtual ~ArpTransport() {}
+
+    virtual int open(const netif::Interface& iface) = 0;
+
+    /**
+     * File descriptor to poll for `POLLIN` (and `POLLOUT` while busy).
+     */
+    virtual int fd() const = 0;
+
+    /**
+     * Queues a request for `tpa`. Depending on the implementation the request is sent immediately or on `flush()`.
+     */
+    virtual TxStatus send(const ip::Addr4& tpa) = 0;
+
+    virtual void flush() = 0;
+
+    /**
+     * Calls `handler` for every frame received since the last call, does not block.
+     */
+    virtual void receive(const frame_handler& handler) = 0;
+
+    /**
+     * Number of send and receive syscalls made so far.
+     */
+    virtual size_t syscallCount() const = 0;
+
+    /**
+     * Joins the opened socket to the `PACKET_FANOUT` group `group` of its interface. If `group` is 0, a new group is
+     * created and its id is stored to `group`. The group hands every frame to one socket only, the one at the index of
+     * the ARP sender address modulo the number of sockets, in the order they have joined.
+     */
+    int joinFanout(uint16_t& group);
+
+    static std::unique_ptr<app::ArpTransport> create(const app::Options& options);
+};
+
+} // namespace app
+
+
+#endif // IG_APPLICATION_ARPTRANSPORT_H
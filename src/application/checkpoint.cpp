@@ -0,0 +1,139 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "application/options.h"
+#include "checkpoint.h"
+#include "middleware/cli.h"
+
+#include <json/json.hpp>
+#include <omw/version.h>
+
+
+using json = nlohmann::json;
+
+// JSON keys
+namespace key {
+
+static const char* const version = "Version";
+
+namespace v1 {
+    static const char* const fingerprint = "Fingerprint";
+    static const char* const seed = "Seed";
+    static const char* const position = "Position";
+} // namespace v1
+
+} // namespace key
+
+
+
+static void hash(uint64_t& h, const std::string& str);
+
+
+
+int app::Checkpoint::read(const std::string& path)
+{
+    try
+    {
+        std::ifstream ifs;
+        ifs.exceptions(std::ifstream::badbit | std::ifstream::failbit);
+        ifs.open(path, std::ios::in | std::ios::binary);
+
+        const json j = json::parse(ifs);
+        const omw::Version v = j.at(key::version);
+
+        if (v.major() != 1)
+        {
+            cli::printError("can't parse checkpoint file v" + v.toString());
+            return -(__LINE__);
+        }
+
+        m_fingerprint = j.at(key::v1::fingerprint).get<std::string>();
+        m_seed = j.at(key::v1::seed).get<uint64_t>();
+        m_position = j.at(key::v1::position).get<uint64_t>();
+    }
+    catch (const std::exception& ex)
+    {
+        cli::printError("failed to read checkpoint file \"" + path + "\"", ex.what());
+        return -(__LINE__);
+    }
+    catch (...)
+    {
+        cli::printError("failed to read checkpoint file \"" + path + "\"");
+        return -(__LINE__);
+    }
+
+    return 0;
+}
+
+int app::Checkpoint::write(const std::string& path) const
+{
+    try
+    {
+        json j = json(json::value_t::object);
+
+        j[key::version] = "1.0.0";
+        j[key::v1::fingerprint] = m_fingerprint;
+        j[key::v1::seed] = m_seed;
+        j[key::v1::position] = m_position;
+
+        std::ofstream ofs;
+        ofs.exceptions(std::ifstream::badbit | std::ifstream::failbit);
+        ofs.open(path, std::ios::out | std::ios::binary);
+
+        ofs << j << std::endl;
+    }
+    catch (const std::exception& ex)
+    {
+        cli::printError("failed to write checkpoint file \"" + path + "\"", ex.what());
+        return -(__LINE__);
+    }
+    catch (...)
+    {
+        cli::printError("failed to write checkpoint file \"" + path + "\"");
+        return -(__LINE__);
+    }
+
+    return 0;
+}
+
+std::string app::Checkpoint::fingerprintOf(const std::vector<std::string>& args, const app::Options& options)
+{
+    uint64_t h = 0xCBF29CE484222325; // FNV-1a offset basis
+
+    for (const auto& arg : args) { hash(h, arg); }
+    hash(h, options.excludeFile());
+    hash(h, options.inputFile());
+    hash(h, (options.randomize() ? "random" : "ascending"));
+    hash(h, std::to_string(options.shardIndex()) + "/" + std::to_string(options.shardCount()));
+
+    std::ostringstream ss;
+    ss << std::hex << std::setw(16) << std::setfill('0') << h;
+    return ss.str();
+}
+
+
+
+/**
+ * FNV-1a, the terminating null is hashed too so that the arguments can't be shifted into each other.
+ */
+void hash(uint64_t& h, const std::string& str)
+{
+    constexpr uint64_t prime = 0x100000001B3;
+
+    for (size_t i = 0; i <= str.size(); ++i)
+    {
+        h ^= (uint8_t)(i < str.size() ? str[i] : '\0');
+        h *= prime;
+    }
+}
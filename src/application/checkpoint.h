@@ -0,0 +1,69 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_APPLICATION_CHECKPOINT_H
+#define IG_APPLICATION_CHECKPOINT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "application/options.h"
+
+
+namespace app {
+
+/**
+ * @brief State of an interrupted sweep, to continue it with `--resume`.
+ *
+ * The sweeps finish the probes which are in flight before they return, so there are no pending targets and the number
+ * of generated targets is the position to continue from. The fingerprint identifies the arguments which determine the
+ * targets and their order, a checkpoint is only valid for the same arguments.
+ */
+class Checkpoint
+{
+public:
+    Checkpoint()
+        : m_fingerprint(), m_seed(0), m_position(0)
+    {}
+
+    Checkpoint(const std::string& fingerprint, uint64_t seed, uint64_t position)
+        : m_fingerprint(fingerprint), m_seed(seed), m_position(position)
+    {}
+
+    virtual ~Checkpoint() {}
+
+    const std::string& fingerprint() const { return m_fingerprint; }
+    uint64_t seed() const { return m_seed; }         ///< of the random order, the arguments may not contain it
+    uint64_t position() const { return m_position; } ///< number of targets which have been scanned
+
+    /**
+     * Prints an error message and returns non 0 on failure.
+     */
+    int read(const std::string& path);
+
+    /**
+     * Prints an error message and returns non 0 on failure.
+     */
+    int write(const std::string& path) const;
+
+    /**
+     * Hash of the ADDR arguments and the options which determine the targets and their order. The content of a target
+     * list isn't part of it.
+     */
+    static std::string fingerprintOf(const std::vector<std::string>& args, const app::Options& options);
+
+private:
+    std::string m_fingerprint;
+    uint64_t m_seed;
+    uint64_t m_position;
+};
+
+} // namespace app
+
+
+#endif // IG_APPLICATION_CHECKPOINT_H
@@ -0,0 +1,556 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "application/options.h"
+#include "application/probe-tracker.h"
+#include "application/result.h"
+#include "icmp-sweep.h"
+#include "middleware/cli.h"
+#include "middleware/icmp-echo.h"
+#include "middleware/io-uring.h"
+#include "middleware/ip-addr.h"
+#include "middleware/mac-addr.h"
+#include "middleware/pacer.h"
+#include "middleware/rtt-estimator.h"
+
+#include <omw/cli.h>
+#include <omw/clock.h>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <linux/icmp.h>
+#include <linux/io_uring.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+
+using omw::clock::timepoint_t;
+using std::cout;
+using std::endl;
+
+
+
+namespace {
+
+constexpr timepoint_t initialTimeout_us = 1000000; // time to wait for a reply until the first RTT has been measured
+constexpr timepoint_t minTimeout_us = 100000;      // routed paths have more jitter than a LAN
+constexpr timepoint_t maxTimeout_us = 3000000;
+constexpr size_t txBurst = 64; // max number of requests sent between two receive calls
+constexpr size_t maxPending = 65536; // max number of targets waiting for a reply, keeps the memory bounded on large ranges
+constexpr int socketBufferSize = 4 * 1024 * 1024;
+constexpr int stallRetry_ms = 10; // poll timeout while the targets are stalled
+constexpr unsigned int uringEntries = 2048;
+constexpr size_t uringTxSlots = 1024; // max number of requests in flight in the ring
+constexpr size_t uringRxBuffers = 1024;
+constexpr size_t rxBufferSize = 256;
+constexpr uint16_t uringBufferGroup = 0;
+constexpr uint64_t uringRxUserData = UINT64_MAX; // the send requests are identified by their slot index
+
+enum class TxStatus
+{
+    sent,
+    busy,   ///< socket buffer full, try again later
+    failed, ///< the target is not reachable
+};
+
+/**
+ * @brief ICMP socket on which the echo requests to all targets are multiplexed.
+ *
+ * With io_uring the requests are queued as `sendmsg()` requests, which are submitted together by `flush()`, and the
+ * replies are received by one multishot receive into provided buffers. `fd()` is then the ring fd, which is readable
+ * while completions are ready.
+ */
+class EchoSocket
+{
+public:
+    EchoSocket()
+        : m_fd(-1), m_raw(false), m_id(0), m_seq(0), m_cookie(0), m_syscalls(0), m_txSlots(), m_freeTxSlots(), m_uring(), m_uringActive(false), m_rxArmed(false), m_rxCount(0)
+    {}
+
+    virtual ~EchoSocket()
+    {
+        if (m_fd >= 0) { close(m_fd); }
+    }
+
+    EchoSocket(const EchoSocket& other) = delete;
+    EchoSocket& operator=(const EchoSocket& other) = delete;
+
+    /**
+     * If `uring` is set and io_uring can't be set up, a warning is printed and the plain socket is used.
+     */
+    int open(bool uring);
+
+    int fd() const { return (m_uringActive ? m_uring.fd() : m_fd); }
+    bool raw() const { return m_raw; }
+    bool uring() const { return m_uringActive; }
+    size_t syscallCount() const { return m_syscalls + m_uring.syscallCount(); }
+
+    TxStatus send(const ip::Addr4& target);
+
+    /**
+     * Submits the requests queued since the last call, does nothing without io_uring.
+     */
+    int flush();
+
+    /**
+     * Calls `handler` with the target address of every echo reply which is ready.
+     */
+    void receive(const std::function<void(const ip::Addr4& target, timepoint_t rxTime)>& handler);
+
+private:
+    int m_fd;
+    bool m_raw;
+    uint16_t m_id;
+    uint16_t m_seq;
+    uint32_t m_cookie;
+    size_t m_syscalls;
+
+    struct TxSlot
+    {
+        uint8_t packet[icmp::echo_size];
+        struct sockaddr_in dest;
+        struct iovec iov;
+        struct msghdr msg;
+    };
+
+    std::vector<TxSlot> m_txSlots; // referenced by the requests in flight, destroyed after the ring
+    std::vector<uint16_t> m_freeTxSlots;
+    IoUring m_uring;
+    bool m_uringActive;
+    bool m_rxArmed; // the multishot receive is queued or running
+    size_t m_rxCount;
+
+    int openUring();
+    TxStatus sendUring(const ip::Addr4& target);
+    void receiveUring(const std::function<void(const ip::Addr4& target, timepoint_t rxTime)>& handler);
+    bool parseReply(const uint8_t* buffer, size_t size, ip::Addr4& target) const;
+    void fallBack(const std::string& reason);
+};
+
+} // namespace
+
+
+
+static void printStats(const EchoSocket& sock, const app::ProbeTracker& tracker, size_t probeCount, size_t pollCount);
+
+
+
+int app::icmpSweep(app::TargetGenerator& targets, const app::ResultHandler& handler, const app::Options& options)
+{
+    EchoSocket sock;
+    if (sock.open(options.uring())) { return -(__LINE__); }
+
+    Pacer pacer;
+    if (pacer.open(options.rate(), options.burst())) { return -(__LINE__); }
+
+    app::ProbeTracker tracker(initialTimeout_us, minTimeout_us, maxTimeout_us);
+    tracker.reserve(std::min(targets.size(), maxPending));
+
+    ip::Addr4 next;
+    bool more = targets.next(next); // `next` is the next target to send to
+    bool stalled = (!more && targets.stalled()); // no target available yet, more will follow
+
+    const auto pull = [&]() {
+        more = targets.next(next);
+        stalled = (!more && targets.stalled());
+    };
+    size_t probeCount = 0;
+    size_t pollCount = 0;
+    bool txBlocked = false;
+
+    const auto send = [&](const ip::Addr4& addr) {
+        const TxStatus status = sock.send(addr);
+
+        if (status == TxStatus::busy) { txBlocked = true; }
+        else if (status == TxStatus::sent)
+        {
+            pacer.consume();
+            ++probeCount;
+        }
+
+        return status;
+    };
+
+    while (more || stalled || !tracker.empty())
+    {
+        const timepoint_t now = omw::clock::now();
+
+        if (stalled) { pull(); }
+
+        // retransmissions are not held back, they delay the following new requests instead
+        txBlocked = false;
+        tracker.expire(
+            now,
+            [&](const ip::Addr4& addr) {
+                const TxStatus status = send(addr);
+                if (status == TxStatus::sent) { return app::ProbeTracker::TxResult::sent; }
+                return (status == TxStatus::busy ? app::ProbeTracker::TxResult::busy : app::ProbeTracker::TxResult::failed);
+            },
+            [&](const ip::Addr4& addr) { targets.finished(addr); });
+
+        for (size_t i = 0; (i < txBurst) && more && (tracker.size() < maxPending) && !txBlocked && pacer.ready(now); ++i)
+        {
+            const TxStatus status = send(next);
+            if (status == TxStatus::busy) { break; }
+
+            // on failure the error has been printed and the target is skipped
+            if (status == TxStatus::sent) { tracker.sent(next, now); }
+            else { targets.finished(next); }
+
+            pull();
+        }
+
+        // compute the poll timeout
+        int timeout_ms = 100;
+        bool paced = false;
+
+        if (more && (tracker.size() < maxPending) && !txBlocked)
+        {
+            if (pacer.ready(now)) { timeout_ms = 0; }
+            else { paced = true; }
+        }
+        else if (txBlocked) { timeout_ms = 1; }
+        else if (stalled) { timeout_ms = stallRetry_ms; }
+
+        const timepoint_t deadline = tracker.nextDeadline();
+        if (deadline >= 0)
+        {
+            const timepoint_t dt = (deadline > now ? deadline - now : 0);
+            timeout_ms = std::min(timeout_ms, (int)((dt + 999) / 1000));
+        }
+
+        // the timer wakes the loop up when the next request may be sent
+        if (paced) { pacer.arm(now); }
+
+        if (sock.flush()) { return -(__LINE__); }
+
+        struct pollfd pfds[2];
+        pfds[0].fd = sock.fd();
+        pfds[0].events = POLLIN | (txBlocked && !sock.uring() ? POLLOUT : 0); // the ring becomes readable when a slot is free
+        pfds[0].revents = 0;
+        pfds[1].fd = (paced ? pacer.fd() : -1);
+        pfds[1].events = POLLIN;
+        pfds[1].revents = 0;
+
+        ++pollCount;
+        const int n = poll(pfds, 2, timeout_ms);
+        if ((n < 0) && (errno != EINTR))
+        {
+            cli::printError("poll() failed", std::strerror(errno));
+            return -(__LINE__);
+        }
+
+        if ((n > 0) && (pfds[1].revents & POLLIN)) { pacer.acknowledge(); }
+
+        if ((n > 0) && (pfds[0].revents & POLLIN))
+        {
+            sock.receive([&](const ip::Addr4& target, timepoint_t rxTime) {
+                timepoint_t rtt_us;
+                if (!tracker.replied(target, rxTime, rtt_us)) { return; } // not a target, or already answered
+
+                handler(app::ScanResult(target, mac::Addr::null, (uint32_t)((rtt_us + 500) / 1000), app::Vendor()));
+                targets.finished(target);
+            });
+        }
+    }
+
+    if (options.stats()) { printStats(sock, tracker, probeCount, pollCount); }
+
+    return 0;
+}
+
+
+
+int EchoSocket::open(bool uring)
+{
+    m_fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_ICMP);
+
+    if (m_fd < 0)
+    {
+        const int dgramErr = errno;
+
+        m_fd = socket(AF_INET, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_ICMP);
+        if (m_fd < 0)
+        {
+            cli::printError("failed to open ICMP socket, the group of the process is not in net.ipv4.ping_group_range and CAP_NET_RAW is missing",
+                            std::strerror(dgramErr));
+            return -(__LINE__);
+        }
+
+        m_raw = true;
+
+        // the raw socket receives a copy of all ICMP messages, only echo replies are of interest
+        struct icmp_filter filter;
+        filter.data = ~(1u << ICMP_ECHOREPLY);
+        (void)setsockopt(m_fd, SOL_RAW, ICMP_FILTER, &filter, sizeof(filter));
+    }
+
+    // a large buffer prevents dropping replies while the requests are sent at full rate
+    const int bufSize = socketBufferSize;
+    (void)setsockopt(m_fd, SOL_SOCKET, SO_RCVBUF, &bufSize, sizeof(bufSize));
+    (void)setsockopt(m_fd, SOL_SOCKET, SO_SNDBUF, &bufSize, sizeof(bufSize));
+
+    // the kernel replaces the identifier of an unprivileged socket by the local port and filters the replies by it
+    m_id = (uint16_t)getpid();
+
+    std::random_device rd;
+    m_cookie = (uint32_t)rd();
+
+    if (uring)
+    {
+        const int err = this->openUring();
+        if (err == 0) { m_uringActive = true; }
+        else { cli::printWarning(std::string("io_uring is not available (") + std::strerror(err) + "), falling back to sockets"); }
+    }
+
+    return 0;
+}
+
+TxStatus EchoSocket::send(const ip::Addr4& target)
+{
+    if (m_uringActive) { return this->sendUring(target); }
+
+    uint8_t packet[icmp::echo_size];
+    icmp::buildEchoRequest(packet, m_id, m_seq++, m_cookie, target);
+
+    struct sockaddr_in sin;
+    std::memset(&sin, 0, sizeof(sin));
+    sin.sin_family = AF_INET;
+    sin.sin_addr.s_addr = htonl(target.value());
+
+    ++m_syscalls;
+    if (sendto(m_fd, packet, sizeof(packet), MSG_DONTWAIT, (const struct sockaddr*)(&sin), sizeof(sin)) < 0)
+    {
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == ENOBUFS)) { return TxStatus::busy; }
+
+        if ((errno != EHOSTUNREACH) && (errno != ENETUNREACH) && (errno != EHOSTDOWN))
+        {
+            cli::printError("sendto() failed on " + target.toString(), std::strerror(errno));
+        }
+
+        return TxStatus::failed;
+    }
+
+    return TxStatus::sent;
+}
+
+int EchoSocket::flush()
+{
+    if (!m_uringActive) { return 0; }
+
+    if (!m_rxArmed)
+    {
+        struct io_uring_sqe* const sqe = m_uring.sqe();
+        if (sqe)
+        {
+            sqe->opcode = IORING_OP_RECV;
+            sqe->fd = m_fd;
+            sqe->ioprio = IORING_RECV_MULTISHOT;
+            sqe->flags = IOSQE_BUFFER_SELECT;
+            sqe->buf_group = uringBufferGroup;
+            sqe->user_data = uringRxUserData;
+
+            m_rxArmed = true;
+        }
+    }
+
+    return m_uring.submit();
+}
+
+void EchoSocket::receive(const std::function<void(const ip::Addr4& target, timepoint_t rxTime)>& handler)
+{
+    if (m_uringActive)
+    {
+        this->receiveUring(handler);
+        return;
+    }
+
+    uint8_t buffer[rxBufferSize];
+
+    while (true)
+    {
+        ++m_syscalls;
+        const ssize_t n = recv(m_fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (n < 0)
+        {
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)) { break; }
+
+            // pending ICMP errors of earlier requests
+            if ((errno == EHOSTUNREACH) || (errno == ENETUNREACH) || (errno == EHOSTDOWN) || (errno == ECONNREFUSED)) { continue; }
+
+            cli::printError("recv() failed on ICMP socket", std::strerror(errno));
+            break;
+        }
+
+        ip::Addr4 target;
+        if (this->parseReply(buffer, (size_t)n, target)) { handler(target, omw::clock::now()); }
+    }
+}
+
+int EchoSocket::openUring()
+{
+    int err = m_uring.open(uringEntries);
+    if (err == 0) { err = m_uring.provideBuffers(uringBufferGroup, uringRxBuffers, rxBufferSize); }
+    if (err != 0) { return err; }
+
+    // the ring waits for the socket itself, a non blocking socket would complete the requests with EAGAIN instead
+    const int flags = fcntl(m_fd, F_GETFL);
+    if ((flags < 0) || (fcntl(m_fd, F_SETFL, flags & ~O_NONBLOCK) != 0)) { return errno; }
+
+    m_txSlots.resize(uringTxSlots);
+    m_freeTxSlots.reserve(uringTxSlots);
+    for (size_t i = uringTxSlots; i > 0; --i) { m_freeTxSlots.push_back((uint16_t)(i - 1)); }
+
+    return 0;
+}
+
+TxStatus EchoSocket::sendUring(const ip::Addr4& target)
+{
+    if (m_freeTxSlots.empty()) { return TxStatus::busy; }
+
+    struct io_uring_sqe* const sqe = m_uring.sqe();
+    if (!sqe) { return TxStatus::busy; }
+
+    const uint16_t idx = m_freeTxSlots.back();
+    m_freeTxSlots.pop_back();
+
+    TxSlot& slot = m_txSlots[idx];
+    icmp::buildEchoRequest(slot.packet, m_id, m_seq++, m_cookie, target);
+
+    std::memset(&slot.dest, 0, sizeof(slot.dest));
+    slot.dest.sin_family = AF_INET;
+    slot.dest.sin_addr.s_addr = htonl(target.value());
+
+    slot.iov.iov_base = slot.packet;
+    slot.iov.iov_len = sizeof(slot.packet);
+
+    std::memset(&slot.msg, 0, sizeof(slot.msg));
+    slot.msg.msg_name = &slot.dest;
+    slot.msg.msg_namelen = sizeof(slot.dest);
+    slot.msg.msg_iov = &slot.iov;
+    slot.msg.msg_iovlen = 1;
+
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = m_fd;
+    sqe->addr = (uint64_t)(uintptr_t)(&slot.msg);
+    sqe->len = 1;
+    sqe->user_data = idx;
+
+    return TxStatus::sent;
+}
+
+void EchoSocket::receiveUring(const std::function<void(const ip::Addr4& target, timepoint_t rxTime)>& handler)
+{
+    const timepoint_t now = omw::clock::now();
+    std::string error;
+
+    m_uring.reap([&](uint64_t userData, int32_t res, uint32_t flags) {
+        if (userData != uringRxUserData)
+        {
+            const TxSlot& slot = m_txSlots[userData];
+            m_freeTxSlots.push_back((uint16_t)userData);
+
+            // a request which couldn't be sent is lost, it's retransmitted when its reply times out
+            if ((res < 0) && (res != -EAGAIN) && (res != -ENOBUFS) && (res != -EHOSTUNREACH) && (res != -ENETUNREACH) && (res != -EHOSTDOWN))
+            {
+                const ip::Addr4 target(ntohl(slot.dest.sin_addr.s_addr));
+                cli::printError("sendmsg() failed on " + target.toString(), std::strerror(-res));
+            }
+
+            return;
+        }
+
+        if ((flags & IORING_CQE_F_MORE) == 0) { m_rxArmed = false; }
+
+        if (flags & IORING_CQE_F_BUFFER)
+        {
+            const uint16_t bid = (uint16_t)(flags >> IORING_CQE_BUFFER_SHIFT);
+
+            ip::Addr4 target;
+            if ((res > 0) && this->parseReply(m_uring.buffer(bid), (size_t)res, target)) { handler(target, now); }
+
+            m_uring.recycle(bid);
+            ++m_rxCount;
+        }
+        else if (res < 0)
+        {
+            // ENOBUFS if all buffers were in use, and pending ICMP errors of earlier requests, the receive is re-armed
+            if (((res != -ENOBUFS) || (m_rxCount == 0)) && (res != -EHOSTUNREACH) && (res != -ENETUNREACH) && (res != -EHOSTDOWN) && (res != -ECONNREFUSED) &&
+                (res != -EINTR) && (res != -EAGAIN))
+            {
+                // before any reply, multishot receive is supported since Linux 6.0
+                if (((res == -EINVAL) || (res == -ENOBUFS)) && (m_rxCount == 0)) { error = "multishot receive is not supported"; }
+                else { error = std::string("receive failed: ") + std::strerror(-res); }
+            }
+        }
+    });
+
+    if (!error.empty()) { this->fallBack(error); }
+}
+
+bool EchoSocket::parseReply(const uint8_t* buffer, size_t size, ip::Addr4& target) const
+{
+    const uint8_t* packet = buffer;
+
+    if (m_raw)
+    {
+        const size_t hdrSize = icmp::ipHeaderSize(buffer, size);
+        if (hdrSize == 0) { return false; }
+
+        packet += hdrSize;
+        size -= hdrSize;
+    }
+
+    uint16_t id;
+    if (!icmp::parseEchoReply(packet, size, m_cookie, id, target)) { return false; }
+
+    return (!m_raw || (id == m_id));
+}
+
+void EchoSocket::fallBack(const std::string& reason)
+{
+    // the requests which are still in the ring are completed or lost, lost ones are retransmitted on timeout
+    cli::printWarning("io_uring " + reason + ", falling back to sockets");
+    m_uringActive = false;
+}
+
+void printStats(const EchoSocket& sock, const app::ProbeTracker& tracker, size_t probeCount, size_t pollCount)
+{
+    const size_t syscalls = sock.syscallCount() + pollCount;
+    const RttEstimator& rtt = tracker.rtt();
+
+    const auto toMs = [](timepoint_t t_us) {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(2) << ((double)t_us / 1000.0);
+        return ss.str();
+    };
+
+    cout << omw::fgBrightBlack;
+
+    cout << (sock.raw() ? "raw" : "unprivileged") << " ICMP socket" << (sock.uring() ? " with io_uring" : "") << ": ";
+    if (rtt.sampleCount() > 0) { cout << "srtt " << toMs(rtt.srtt()) << "ms, rttvar " << toMs(rtt.rttvar()) << "ms, "; }
+    cout << "timeout " << toMs(rtt.rto()) << "ms, " << tracker.requestCount() << " requests per target, ";
+    cout << rtt.sampleCount() << " samples, " << tracker.lateReplyCount() << "/" << tracker.replyCount() << " replies after retransmission" << endl;
+
+    cout << "probes: " << probeCount << ", syscalls: " << syscalls << " (" << pollCount << " poll)";
+    if (probeCount > 0) { cout << ", " << ((syscalls * 1000 + probeCount / 2) / probeCount) << " syscalls per 1k probes"; }
+    cout << omw::fgDefault << endl;
+}
@@ -0,0 +1,34 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_APPLICATION_ICMPSWEEP_H
+#define IG_APPLICATION_ICMPSWEEP_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "application/options.h"
+#include "application/result.h"
+#include "application/targets.h"
+#include "middleware/ip-addr.h"
+
+
+namespace app {
+
+/**
+ * Scans the addresses generated by `targets` by ICMP echo requests, which reach routed subnets too. All requests are
+ * sent and received on one socket, `handler` is called once for every host that replied. The results have no MAC
+ * address.
+ *
+ * An unprivileged ICMP socket is used if the group of the process is in `net.ipv4.ping_group_range`, otherwise a raw
+ * socket, which requires `CAP_NET_RAW`. Blocks until every target has replied or timed out, returns 0 on success.
+ */
+int icmpSweep(app::TargetGenerator& targets, const app::ResultHandler& handler, const app::Options& options);
+
+} // namespace app
+
+
+#endif // IG_APPLICATION_ICMPSWEEP_H
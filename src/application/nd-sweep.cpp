@@ -0,0 +1,361 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "application/options.h"
+#include "application/result.h"
+#include "middleware/cli.h"
+#include "middleware/icmp6.h"
+#include "middleware/ip-addr.h"
+#include "middleware/mac-addr.h"
+#include "middleware/neigh-table.h"
+#include "middleware/net-if.h"
+#include "nd-sweep.h"
+
+#include <omw/cli.h>
+#include <omw/clock.h>
+
+#include <netinet/icmp6.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+
+using omw::clock::timepoint_t;
+using std::cout;
+using std::endl;
+
+
+
+namespace {
+
+constexpr int probeRounds = 3;                   // multicast is not acknowledged, so it's repeated
+constexpr timepoint_t roundInterval_us = 300000;
+constexpr timepoint_t collectTime_us = 1500000;  // time to wait for replies after the last round
+constexpr int socketBufferSize = 4 * 1024 * 1024;
+
+struct Host
+{
+    mac::Addr mac;
+    timepoint_t rtt; // only valid if `replied`
+    bool replied;    // has sent an echo reply, otherwise it has only been seen in a neighbour discovery message
+};
+
+/**
+ * @brief ICMPv6 socket on which the multicast echo requests of all interfaces are sent and the answers are received.
+ */
+class EchoSocket6
+{
+public:
+    EchoSocket6()
+        : m_fd(-1), m_raw(false), m_id(0), m_seq(0), m_cookie(0)
+    {}
+
+    virtual ~EchoSocket6()
+    {
+        if (m_fd >= 0) { close(m_fd); }
+    }
+
+    EchoSocket6(const EchoSocket6& other) = delete;
+    EchoSocket6& operator=(const EchoSocket6& other) = delete;
+
+    int open();
+    int fd() const { return m_fd; }
+    bool raw() const { return m_raw; }
+
+    /**
+     * Sends an echo request to `ff02::1` on interface `ifindex` with source address `src`. The sequence number of the
+     * request is written to `seq`.
+     */
+    int send(int ifindex, const ip::Addr6& src, uint16_t& seq);
+
+    /**
+     * Reads all messages which are ready. Echo replies are passed to `echoHandler` with the sequence number of the
+     * request which they answer, neighbour discovery messages which carry a link layer address to `ndHandler`.
+     */
+    void receive(const std::function<void(const ip::Addr6& src, uint16_t seq)>& echoHandler,
+                 const std::function<void(const ip::Addr6& ip, const mac::Addr& mac)>& ndHandler);
+
+private:
+    int m_fd;
+    bool m_raw;
+    uint16_t m_id;
+    uint16_t m_seq;
+    uint32_t m_cookie;
+};
+
+} // namespace
+
+
+
+int app::ndSweep(const ip::Addr6& prefix, const ip::SubnetMask6& mask, const app::ResultHandler& handler, const app::Options& options)
+{
+    const auto interfaces = netif::getInterfaces6();
+    if (interfaces.empty())
+    {
+        cli::printWarning("no interface with an IPv6 address");
+        return 0;
+    }
+
+    EchoSocket6 sock;
+    if (sock.open()) { return -(__LINE__); }
+
+    const ip::Addr6 network = (prefix & mask);
+    const auto inRange = [&](const ip::Addr6& addr) { return ((addr & mask) == network); };
+    const auto isLocal = [&](const ip::Addr6& addr) {
+        return std::any_of(interfaces.begin(), interfaces.end(), [&addr](const netif::Interface6& iface) { return (iface.ip() == addr); });
+    };
+
+    std::map<ip::Addr6, Host> hosts;
+    std::map<uint16_t, timepoint_t> sendTimes; // by sequence number, a reply is timed against the request it answers
+    size_t echoCount = 0;
+    size_t ndCount = 0;
+    size_t requestCount = 0;
+
+    timepoint_t lastSent = 0;
+    int round = 0;
+    timepoint_t end = omw::clock::now() + (probeRounds - 1) * roundInterval_us + collectTime_us;
+
+    while (true)
+    {
+        const timepoint_t now = omw::clock::now();
+        if (now >= end) { break; }
+
+        if ((round < probeRounds) && ((round == 0) || ((now - lastSent) >= roundInterval_us)))
+        {
+            // every source address gets the answers of the hosts which use the same scope
+            for (const auto& iface : interfaces)
+            {
+                uint16_t seq;
+                if (sock.send(iface.index(), iface.ip(), seq) == 0)
+                {
+                    sendTimes[seq] = omw::clock::now();
+                    ++requestCount;
+                }
+            }
+
+            lastSent = now;
+            ++round;
+        }
+
+        const timepoint_t nextEvent = (round < probeRounds ? lastSent + roundInterval_us : end);
+        const int timeout_ms = (int)(((nextEvent > now ? nextEvent - now : 0) + 999) / 1000);
+
+        struct pollfd pfd;
+        pfd.fd = sock.fd();
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+
+        const int n = poll(&pfd, 1, timeout_ms);
+        if ((n < 0) && (errno != EINTR))
+        {
+            cli::printError("poll() failed", std::strerror(errno));
+            return -(__LINE__);
+        }
+
+        if ((n <= 0) || !(pfd.revents & POLLIN)) { continue; }
+
+        const timepoint_t rxTime = omw::clock::now();
+
+        sock.receive(
+            [&](const ip::Addr6& src, uint16_t seq) {
+                ++echoCount;
+                if (isLocal(src)) { return; }
+
+                const auto sent = sendTimes.find(seq);
+                if (sent == sendTimes.end()) { return; } // not a request of this sweep
+
+                Host& host = hosts[src];
+                if (!host.replied)
+                {
+                    host.rtt = (rxTime > sent->second ? rxTime - sent->second : 0);
+                    host.replied = true;
+                }
+            },
+            [&](const ip::Addr6& ip, const mac::Addr& mac) {
+                ++ndCount;
+                if (isLocal(ip)) { return; }
+
+                Host& host = hosts[ip];
+                host.mac = mac;
+            });
+    }
+
+    // the unprivileged socket doesn't receive neighbour discovery messages
+    if (std::any_of(hosts.begin(), hosts.end(), [](const std::pair<const ip::Addr6, Host>& h) { return (h.second.mac == mac::Addr::null); }))
+    {
+        std::vector<neigh::Entry6> table;
+        if (neigh::dump(table) == 0)
+        {
+            for (const auto& entry : table)
+            {
+                const auto it = hosts.find(entry.ip());
+                if ((it != hosts.end()) && (it->second.mac == mac::Addr::null)) { it->second.mac = entry.mac(); }
+            }
+        }
+    }
+
+    for (const auto& h : hosts)
+    {
+        const ip::Addr6& addr = h.first;
+        const Host& host = h.second;
+
+        if (!inRange(addr)) { continue; }
+
+        const uint32_t duration_ms = (host.replied ? (uint32_t)((host.rtt + 500) / 1000) : app::ScanResult::no_duration);
+        handler(app::ScanResult(addr, host.mac, duration_ms, app::Vendor()));
+    }
+
+    if (options.stats())
+    {
+        cout << omw::fgBrightBlack;
+        cout << (sock.raw() ? "raw" : "unprivileged") << " ICMPv6 socket: " << requestCount << " multicast requests, " << echoCount << " echo replies, ";
+        cout << ndCount << " neighbour discovery messages";
+        cout << omw::fgDefault << endl;
+    }
+
+    return 0;
+}
+
+
+
+int EchoSocket6::open()
+{
+    m_fd = socket(AF_INET6, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_ICMPV6);
+
+    if (m_fd >= 0)
+    {
+        m_raw = true;
+
+        struct icmp6_filter filter;
+        ICMP6_FILTER_SETBLOCKALL(&filter);
+        ICMP6_FILTER_SETPASS(icmp6::type_echo_reply, &filter);
+        ICMP6_FILTER_SETPASS(icmp6::type_neighbour_solicitation, &filter);
+        ICMP6_FILTER_SETPASS(icmp6::type_neighbour_advertisement, &filter);
+        (void)setsockopt(m_fd, IPPROTO_ICMPV6, ICMP6_FILTER, &filter, sizeof(filter));
+    }
+    else
+    {
+        const int rawErr = errno;
+
+        m_fd = socket(AF_INET6, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_ICMPV6);
+        if (m_fd < 0)
+        {
+            cli::printError("failed to open ICMPv6 socket, CAP_NET_RAW is missing and the group of the process is not in net.ipv4.ping_group_range",
+                            std::strerror(rawErr));
+            return -(__LINE__);
+        }
+    }
+
+    const int bufSize = socketBufferSize;
+    (void)setsockopt(m_fd, SOL_SOCKET, SO_RCVBUF, &bufSize, sizeof(bufSize));
+
+    // own requests are of no interest
+    const int loop = 0;
+    (void)setsockopt(m_fd, IPPROTO_IPV6, IPV6_MULTICAST_LOOP, &loop, sizeof(loop));
+
+    // the kernel replaces the identifier of an unprivileged socket by the local port
+    m_id = (uint16_t)getpid();
+
+    std::random_device rd;
+    m_cookie = (uint32_t)rd();
+
+    return 0;
+}
+
+int EchoSocket6::send(int ifindex, const ip::Addr6& src, uint16_t& seq)
+{
+    seq = m_seq++;
+
+    uint8_t packet[icmp6::echo_size];
+    icmp6::buildEchoRequest(packet, m_id, seq, m_cookie);
+
+    struct sockaddr_in6 dst;
+    std::memset(&dst, 0, sizeof(dst));
+    dst.sin6_family = AF_INET6;
+    std::memcpy(dst.sin6_addr.s6_addr, ip::Addr6::allNodes.data(), ip::Addr6::octet_count);
+    dst.sin6_scope_id = (uint32_t)ifindex;
+
+    struct iovec iov;
+    iov.iov_base = packet;
+    iov.iov_len = sizeof(packet);
+
+    // the source address is selected by a IPV6_PKTINFO control message
+    alignas(struct cmsghdr) uint8_t control[CMSG_SPACE(sizeof(struct in6_pktinfo))];
+    std::memset(control, 0, sizeof(control));
+
+    struct msghdr msg;
+    std::memset(&msg, 0, sizeof(msg));
+    msg.msg_name = &dst;
+    msg.msg_namelen = sizeof(dst);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = IPPROTO_IPV6;
+    cmsg->cmsg_type = IPV6_PKTINFO;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(struct in6_pktinfo));
+
+    struct in6_pktinfo pktinfo;
+    std::memset(&pktinfo, 0, sizeof(pktinfo));
+    std::memcpy(pktinfo.ipi6_addr.s6_addr, src.data(), ip::Addr6::octet_count);
+    pktinfo.ipi6_ifindex = (unsigned int)ifindex;
+    std::memcpy(CMSG_DATA(cmsg), &pktinfo, sizeof(pktinfo));
+
+    if (sendmsg(m_fd, &msg, 0) < 0)
+    {
+        // a tentative address (duplicate address detection in progress) can't be used as source yet
+        if (errno != EADDRNOTAVAIL) { cli::printError("failed to send ICMPv6 echo request from " + src.toString(), std::strerror(errno)); }
+        return -(__LINE__);
+    }
+
+    return 0;
+}
+
+void EchoSocket6::receive(const std::function<void(const ip::Addr6& src, uint16_t seq)>& echoHandler,
+                          const std::function<void(const ip::Addr6& ip, const mac::Addr& mac)>& ndHandler)
+{
+    uint8_t buffer[1500];
+
+    while (true)
+    {
+        struct sockaddr_in6 from;
+        socklen_t fromLen = sizeof(from);
+
+        const ssize_t n = recvfrom(m_fd, buffer, sizeof(buffer), MSG_DONTWAIT, (struct sockaddr*)(&from), &fromLen);
+        if (n < 0)
+        {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)) { cli::printError("recvfrom() failed on ICMPv6 socket", std::strerror(errno)); }
+            break;
+        }
+
+        const ip::Addr6 src(from.sin6_addr.s6_addr);
+
+        uint16_t id;
+        uint16_t seq;
+        ip::Addr6 ip;
+        mac::Addr mac;
+
+        if (icmp6::parseEchoReply(buffer, (size_t)n, m_cookie, id, seq))
+        {
+            if (!m_raw || (id == m_id)) { echoHandler(src, seq); }
+        }
+        else if (icmp6::parseNeighbourMessage(buffer, (size_t)n, src, ip, mac)) { ndHandler(ip, mac); }
+    }
+}
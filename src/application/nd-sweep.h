@@ -0,0 +1,35 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_APPLICATION_NDSWEEP_H
+#define IG_APPLICATION_NDSWEEP_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "application/options.h"
+#include "application/result.h"
+#include "middleware/ip-addr.h"
+
+
+namespace app {
+
+/**
+ * Discovers the IPv6 hosts in `prefix`/`mask` on the local links. Sweeping an IPv6 subnet address by address is not
+ * feasible, instead an echo request is sent to the all nodes multicast address `ff02::1` from every address of every
+ * interface. The echo replies and the neighbour solicitations/advertisements the hosts send while answering are
+ * collected on one socket, the latter carry the MAC addresses. `handler` is called once per host after the collection
+ * window, sorted by address.
+ *
+ * A raw ICMPv6 socket is used if `CAP_NET_RAW` is available, otherwise an unprivileged one which only receives the echo
+ * replies, the MAC addresses are taken from the neighbour cache then. Returns 0 on success.
+ */
+int ndSweep(const ip::Addr6& prefix, const ip::SubnetMask6& mask, const app::ResultHandler& handler, const app::Options& options);
+
+} // namespace app
+
+
+#endif // IG_APPLICATION_NDSWEEP_H
@@ -0,0 +1,78 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "application/result.h"
+#include "application/targets.h"
+#include "middleware/ip-addr.h"
+#include "middleware/neigh-table.h"
+#include "neigh-harvest.h"
+
+
+
+static bool lessIP(const neigh::Entry& a, const neigh::Entry& b) { return (a.ip().value() < b.ip().value()); }
+
+
+
+app::NeighbourHarvest::NeighbourHarvest(app::TargetGenerator& targets, const app::ResultHandler& handler)
+    : m_targets(targets), m_handler(handler), m_table(), m_reported(), m_count(0)
+{}
+
+int app::NeighbourHarvest::load(const range_predicate& inRange)
+{
+    std::vector<neigh::Entry> table;
+    const int err = neigh::dump(table);
+    if (err) { return -(__LINE__); } // the error has been printed, all targets are probed
+
+    m_table.clear();
+    for (const auto& entry : table)
+    {
+        if (entry.valid()) { m_table.push_back(entry); }
+    }
+
+    // the same IP may be listed on multiple interfaces
+    std::stable_sort(m_table.begin(), m_table.end(), lessIP);
+    m_table.erase(std::unique(m_table.begin(), m_table.end(), [](const neigh::Entry& a, const neigh::Entry& b) { return (a.ip() == b.ip()); }),
+                  m_table.end());
+
+    m_reported.assign(m_table.size(), false);
+    for (size_t i = 0; i < m_table.size(); ++i)
+    {
+        if (inRange(m_table[i].ip()))
+        {
+            m_handler(app::ScanResult(m_table[i].ip(), m_table[i].mac(), 0, app::Vendor(), true));
+            m_reported[i] = true;
+            ++m_count;
+        }
+    }
+
+    return 0;
+}
+
+bool app::NeighbourHarvest::next(ip::Addr4& addr)
+{
+    while (m_targets.next(addr))
+    {
+        const auto it = std::lower_bound(m_table.begin(), m_table.end(), addr,
+                                         [](const neigh::Entry& entry, const ip::Addr4& value) { return (entry.ip().value() < value.value()); });
+
+        if ((it == m_table.end()) || (it->ip() != addr)) { return true; }
+
+        if (!m_reported[(size_t)(it - m_table.begin())])
+        {
+            m_handler(app::ScanResult(it->ip(), it->mac(), 0, app::Vendor(), true));
+            ++m_count;
+        }
+
+        m_targets.finished(addr);
+    }
+
+    return false;
+}
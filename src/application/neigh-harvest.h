@@ -0,0 +1,65 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_APPLICATION_NEIGHHARVEST_H
+#define IG_APPLICATION_NEIGHHARVEST_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "application/result.h"
+#include "application/targets.h"
+#include "middleware/ip-addr.h"
+#include "middleware/neigh-table.h"
+
+
+namespace app {
+
+/**
+ * @brief Passes the targets of a generator through, except the hosts which are in the kernel neighbour table.
+ *
+ * The hosts in `REACHABLE` or `STALE` state don't need to be probed. The ones which are known to be targets are
+ * reported as cached results by `load()` already, before probing, the others when the generator reaches them. Until
+ * `load()` has been called all targets are passed through.
+ */
+class NeighbourHarvest : public app::TargetGenerator
+{
+public:
+    NeighbourHarvest(app::TargetGenerator& targets, const app::ResultHandler& handler);
+    virtual ~NeighbourHarvest() {}
+
+    NeighbourHarvest(const NeighbourHarvest& other) = delete;
+    NeighbourHarvest& operator=(const NeighbourHarvest& other) = delete;
+
+    using range_predicate = std::function<bool(const ip::Addr4& addr)>;
+
+    /**
+     * Reads the neighbour table and reports the hosts for which `inRange` returns `true` right away, they are skipped
+     * silently when the generator reaches them.
+     */
+    int load(const range_predicate& inRange);
+
+    virtual bool next(ip::Addr4& addr);
+    virtual bool stalled() const { return m_targets.stalled(); }
+    virtual void finished(const ip::Addr4& addr) { m_targets.finished(addr); }
+    virtual size_t size() const { return m_targets.size(); }
+
+    size_t count() const { return m_count; } ///< number of reported hosts
+
+private:
+    app::TargetGenerator& m_targets;
+    app::ResultHandler m_handler;
+    std::vector<neigh::Entry> m_table; // valid entries, sorted by IP, unique
+    std::vector<bool> m_reported;      // by `load()`, parallel to `m_table`
+    size_t m_count;
+};
+
+} // namespace app
+
+
+#endif // IG_APPLICATION_NEIGHHARVEST_H
@@ -0,0 +1,366 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "application/options.h"
+#include "application/result.h"
+#include "middleware/cli.h"
+#include "middleware/ip-addr.h"
+#include "middleware/neigh-table.h"
+#include "middleware/net-if.h"
+#include "middleware/pacer.h"
+#include "neigh-sweep.h"
+
+#include <omw/cli.h>
+#include <omw/clock.h>
+
+#include <arpa/inet.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+
+using omw::clock::timepoint_t;
+using std::cout;
+using std::endl;
+
+
+
+namespace {
+
+constexpr uint16_t triggerPort = 9;                // discard protocol, the datagram itself is of no interest
+constexpr timepoint_t resolveTimeout_us = 5000000; // the kernel gives up after 3 requests 1s apart (mcast_solicit, retrans_time_ms)
+constexpr timepoint_t checkInterval_us = 1000000;  // max time a timed out target waits to be checked against the table
+constexpr size_t minInFlight = 16;
+constexpr int stallRetry_ms = 10; // poll timeout while the targets are stalled
+constexpr int netlinkBufferSize = 8 * 1024 * 1024;
+
+struct Deadline
+{
+    ip::Addr4::value_type ip;
+    timepoint_t time;
+};
+
+/**
+ * @brief Closes the file descriptor when going out of scope.
+ */
+class FileDescriptor
+{
+public:
+    explicit FileDescriptor(int fd)
+        : m_fd(fd)
+    {}
+
+    virtual ~FileDescriptor()
+    {
+        if (m_fd >= 0) { close(m_fd); }
+    }
+
+    FileDescriptor(const FileDescriptor& other) = delete;
+    FileDescriptor& operator=(const FileDescriptor& other) = delete;
+
+    int get() const { return m_fd; }
+    bool good() const { return (m_fd >= 0); }
+
+private:
+    int m_fd;
+};
+
+} // namespace
+
+
+
+static size_t maxInFlight();
+static int openNeighMonitor();
+
+
+
+int app::neighSweep(app::TargetGenerator& targets, const app::ResultHandler& handler, const app::Options& options)
+{
+    const auto interfaces = netif::getInterfaces();
+
+    const auto onLink = [&interfaces](const ip::Addr4& addr) {
+        return std::any_of(interfaces.begin(), interfaces.end(), [&addr](const netif::Interface& iface) { return iface.contains(addr); });
+    };
+
+    // subscribe before the first datagram is sent, so that no event is missed
+    const FileDescriptor nl(openNeighMonitor());
+    if (!nl.good()) { return -(__LINE__); }
+
+    const FileDescriptor udp(socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0));
+    if (!udp.good())
+    {
+        cli::printError("failed to open UDP socket", std::strerror(errno));
+        return -(__LINE__);
+    }
+
+    Pacer pacer;
+    if (pacer.open(options.rate(), options.burst())) { return -(__LINE__); }
+
+    const size_t inFlightLimit = maxInFlight();
+
+    std::unordered_map<ip::Addr4::value_type, timepoint_t> pending;
+    std::deque<Deadline> timeline;
+    std::vector<ip::Addr4::value_type> timedOut; // to be checked against the table, at most `inFlightLimit`
+    timepoint_t timedOutSince = 0;
+    ip::Addr4 next;
+    bool more = targets.next(next); // `next` is the next target to send to
+    bool stalled = (!more && targets.stalled()); // no target available yet, more will follow
+
+    const auto pull = [&]() {
+        more = targets.next(next);
+        stalled = (!more && targets.stalled());
+    };
+    size_t offSubnet = 0;
+    size_t eventCount = 0;
+    size_t datagramCount = 0;
+    bool txBlocked = false;
+    bool overrun = false;
+
+    pending.reserve(inFlightLimit);
+    timedOut.reserve(inFlightLimit);
+
+    // entries which already were reachable don't change state and therefore don't generate an event, the timed out
+    // targets are checked against the table in batches
+    const auto checkTimedOut = [&]() {
+        if (timedOut.empty()) { return; }
+
+        std::sort(timedOut.begin(), timedOut.end());
+
+        std::vector<neigh::Entry> table;
+        if (neigh::dump(table) == 0)
+        {
+            for (const auto& entry : table)
+            {
+                if (entry.valid() && std::binary_search(timedOut.begin(), timedOut.end(), entry.ip().value()))
+                {
+                    handler(app::ScanResult(entry.ip(), entry.mac(), 0, app::Vendor(), true));
+                }
+            }
+        }
+
+        for (const auto& value : timedOut) { targets.finished(ip::Addr4(value)); }
+        timedOut.clear();
+    };
+
+    alignas(struct nlmsghdr) uint8_t buffer[64 * 1024];
+
+    while (more || stalled || !pending.empty())
+    {
+        timepoint_t now = omw::clock::now();
+
+        if (stalled) { pull(); }
+
+        while (!timeline.empty() && (timeline.front().time <= now))
+        {
+            const auto it = pending.find(timeline.front().ip);
+            if (it != pending.end())
+            {
+                if (timedOut.empty()) { timedOutSince = now; }
+                timedOut.push_back(it->first);
+                pending.erase(it);
+            }
+
+            timeline.pop_front();
+
+            if (timedOut.size() >= inFlightLimit) { checkTimedOut(); }
+        }
+
+        if (!timedOut.empty() && ((now - timedOutSince) >= checkInterval_us)) { checkTimedOut(); }
+
+        txBlocked = false;
+
+        while (more && (pending.size() < inFlightLimit) && pacer.ready(now))
+        {
+            const ip::Addr4& addr = next;
+
+            if (!onLink(addr))
+            {
+                ++offSubnet;
+                targets.finished(addr);
+                pull();
+                continue;
+            }
+
+            struct sockaddr_in sin;
+            std::memset(&sin, 0, sizeof(sin));
+            sin.sin_family = AF_INET;
+            sin.sin_port = htons(triggerPort);
+            sin.sin_addr.s_addr = htonl(addr.value());
+
+            if (sendto(udp.get(), nullptr, 0, 0, (const struct sockaddr*)(&sin), sizeof(sin)) < 0)
+            {
+                if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == ENOBUFS))
+                {
+                    txBlocked = true;
+                    break;
+                }
+
+                // EHOSTUNREACH etc. means the resolution has already failed
+                targets.finished(addr);
+            }
+            else
+            {
+                pacer.consume();
+                pending[addr.value()] = now;
+                timeline.push_back(Deadline{ addr.value(), now + resolveTimeout_us });
+                ++datagramCount;
+            }
+
+            pull();
+        }
+
+        int timeout_ms = (txBlocked ? 1 : (stalled ? stallRetry_ms : 100));
+        if (!timeline.empty())
+        {
+            const timepoint_t dt = (timeline.front().time > now ? timeline.front().time - now : 0);
+            timeout_ms = std::min(timeout_ms, (int)((dt + 999) / 1000));
+        }
+        if (!timedOut.empty())
+        {
+            const timepoint_t deadline = timedOutSince + checkInterval_us;
+            const timepoint_t dt = (deadline > now ? deadline - now : 0);
+            timeout_ms = std::min(timeout_ms, (int)((dt + 999) / 1000));
+        }
+
+        // the timer wakes the loop up when the next datagram may be sent
+        const bool paced = (more && (pending.size() < inFlightLimit) && !txBlocked);
+        if (paced) { pacer.arm(now); }
+
+        struct pollfd pfds[2];
+        pfds[0].fd = nl.get();
+        pfds[0].events = POLLIN;
+        pfds[0].revents = 0;
+        pfds[1].fd = (paced ? pacer.fd() : -1);
+        pfds[1].events = POLLIN;
+        pfds[1].revents = 0;
+
+        const int n = poll(pfds, 2, timeout_ms);
+        if ((n < 0) && (errno != EINTR))
+        {
+            cli::printError("poll() failed", std::strerror(errno));
+            return -(__LINE__);
+        }
+
+        if ((n > 0) && (pfds[1].revents & POLLIN)) { pacer.acknowledge(); }
+        if ((n <= 0) || !(pfds[0].revents & POLLIN)) { continue; }
+
+        while (true)
+        {
+            const ssize_t size = recv(nl.get(), buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (size < 0)
+            {
+                // events have been dropped, the affected targets time out and are checked against the table
+                if (errno == ENOBUFS)
+                {
+                    overrun = true;
+                    continue;
+                }
+
+                if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)) { cli::printError("netlink recv() failed", std::strerror(errno)); }
+                break;
+            }
+
+            now = omw::clock::now();
+
+            int len = (int)size;
+            for (const struct nlmsghdr* nh = (const struct nlmsghdr*)buffer; NLMSG_OK(nh, len); nh = NLMSG_NEXT(nh, len))
+            {
+                neigh::Entry entry;
+                if (!neigh::parse(nh, entry)) { continue; }
+
+                ++eventCount;
+
+                const auto it = pending.find(entry.ip().value());
+                if (it == pending.end()) { continue; }
+
+                if (entry.valid() && entry.hasMac())
+                {
+                    const timepoint_t dur_us = now - it->second;
+                    pending.erase(it);
+
+                    handler(app::ScanResult(entry.ip(), entry.mac(), (uint32_t)((dur_us + 500) / 1000), app::Vendor()));
+                    targets.finished(entry.ip());
+                }
+                else if (entry.failed())
+                {
+                    pending.erase(it);
+                    targets.finished(entry.ip());
+                }
+            }
+        }
+    }
+
+    checkTimedOut();
+
+    if (offSubnet > 0) { cli::printWarning(std::to_string(offSubnet) + " addresses are not on a local subnet and are skipped"); }
+    if (overrun) { cli::printWarning("netlink event buffer overrun, results may be incomplete"); }
+
+    if (options.stats())
+    {
+        cout << omw::fgBrightBlack;
+        cout << "datagrams: " << datagramCount << ", neighbour events: " << eventCount << ", concurrent resolutions: " << inFlightLimit;
+        cout << omw::fgDefault << endl;
+    }
+
+    return 0;
+}
+
+
+
+/**
+ * Half of the hard limit of the neighbour table, the other half is left for the system.
+ */
+size_t maxInFlight()
+{
+    size_t gcThresh3 = 1024; // kernel default
+
+    std::ifstream ifs("/proc/sys/net/ipv4/neigh/default/gc_thresh3");
+    if (ifs.good()) { ifs >> gcThresh3; }
+
+    return std::max(gcThresh3 / 2, minInFlight);
+}
+
+int openNeighMonitor()
+{
+    const int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd < 0)
+    {
+        cli::printError("failed to open netlink socket", std::strerror(errno));
+        return -1;
+    }
+
+    const int bufSize = netlinkBufferSize;
+    (void)setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bufSize, sizeof(bufSize));
+
+    struct sockaddr_nl snl;
+    std::memset(&snl, 0, sizeof(snl));
+    snl.nl_family = AF_NETLINK;
+    snl.nl_groups = RTMGRP_NEIGH;
+
+    if (bind(fd, (const struct sockaddr*)(&snl), sizeof(snl)) != 0)
+    {
+        cli::printError("failed to subscribe to neighbour events", std::strerror(errno));
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
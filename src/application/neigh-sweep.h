@@ -0,0 +1,34 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_APPLICATION_NEIGHSWEEP_H
+#define IG_APPLICATION_NEIGHSWEEP_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "application/options.h"
+#include "application/result.h"
+#include "application/targets.h"
+#include "middleware/ip-addr.h"
+
+
+namespace app {
+
+/**
+ * Scans the addresses generated by `targets` without raw sockets. An empty UDP datagram is sent to every target, which
+ * makes the kernel resolve the target's MAC address. The resulting neighbour table changes are received as
+ * `RTM_NEWNEIGH` events (`RTNLGRP_NEIGH`), `handler` is called for every target which has been resolved.
+ *
+ * The number of concurrent resolutions is limited to half of the neighbour table size (`gc_thresh3`). Addresses which
+ * are not on a local subnet are skipped. Blocks until every target is resolved or has failed, returns 0 on success.
+ */
+int neighSweep(app::TargetGenerator& targets, const app::ResultHandler& handler, const app::Options& options);
+
+} // namespace app
+
+
+#endif // IG_APPLICATION_NEIGHSWEEP_H
@@ -0,0 +1,128 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_APPLICATION_OPTIONS_H
+#define IG_APPLICATION_OPTIONS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace app {
+
+/**
+ * @brief Scan method of the Linux sweep.
+ */
+enum class ScanMode
+{
+    arp,   ///< ARP requests on raw sockets, requires `CAP_NET_RAW`
+    neigh, ///< kernel address resolution triggered by UDP datagrams, unprivileged
+    icmp,  ///< ICMP echo requests, reaches routed subnets
+    tcp,   ///< TCP connects to `app::Options::ports()`, for hosts which filter ICMP
+};
+
+/**
+ * @brief I/O method of the Linux ARP sweep.
+ */
+enum class ArpIo
+{
+    socket, ///< one `send()`/`recv()` per frame
+    batch,  ///< `sendmmsg()`/`recvmmsg()` with up to `app::Options::batchSize()` frames per call
+    ring,   ///< PACKET_MMAP TX/RX rings (`TPACKET_V3`)
+};
+
+/**
+ * @brief Scan options set on the command line.
+ */
+class Options
+{
+public:
+    static constexpr size_t default_batch_size = 64;
+    static constexpr size_t default_burst = 16;
+    static constexpr size_t jobs_per_core = 4; // the scan threads spend most of their time waiting for replies
+    static constexpr const char* default_checkpoint_file = "lsip-checkpoint.json";
+
+public:
+    Options()
+        : m_mode(ScanMode::arp), m_arpIo(ArpIo::socket), m_batchSize(default_batch_size), m_fanout(1), m_uring(false), m_rate(0), m_burst(default_burst), m_ports{ 22, 80, 443, 445, 3389, 8080 }, m_jobs(0), m_excludeFile(), m_inputFile(), m_randomize(false), m_seed(0), m_sorted(false), m_shardIndex(0), m_shardCount(1), m_checkpointFile(default_checkpoint_file), m_resume(false), m_neighCache(true), m_stats(false)
+    {}
+
+    virtual ~Options() {}
+
+    app::ScanMode mode() const { return m_mode; }
+    app::ArpIo arpIo() const { return m_arpIo; }
+    size_t batchSize() const { return m_batchSize; }
+    size_t fanout() const { return m_fanout; } ///< number of ARP sweep threads, which share the replies by PACKET_FANOUT
+    bool uring() const { return m_uring; } ///< ICMP sweep through io_uring, falls back to plain syscalls if not supported
+    uint32_t rate() const { return m_rate; } ///< max number of probes per second, 0 if unlimited
+    size_t burst() const { return m_burst; } ///< number of probes which may be sent back to back within the rate
+    const std::vector<uint16_t>& ports() const { return m_ports; } ///< TCP ports probed by `app::ScanMode::tcp`
+    size_t jobs() const { return m_jobs; } ///< number of scan threads of the Windows scan, 0 if selected by the number of cores
+    const std::string& excludeFile() const { return m_excludeFile; } ///< file with addresses which must not be scanned, empty if none
+    const std::string& inputFile() const { return m_inputFile; } ///< file with addresses to scan, "-" for stdin, empty if none
+    bool randomize() const { return m_randomize; } ///< scan the targets in a pseudo random order
+    uint64_t seed() const { return m_seed; }       ///< key of the random order, the same seed gives the same order
+    bool sorted() const { return m_sorted; }       ///< print the results in the order of the targets
+    size_t shardIndex() const { return m_shardIndex; } ///< 0 based index of the slice of the targets which is scanned
+    size_t shardCount() const { return m_shardCount; } ///< number of slices the targets are split into, 1 if not sharded
+    const std::string& checkpointFile() const { return m_checkpointFile; } ///< written if the sweep is interrupted
+    bool resume() const { return m_resume; } ///< continue the sweep of `checkpointFile()`
+    bool neighCache() const { return m_neighCache; } ///< report hosts from the kernel neighbour table without probing them
+    bool stats() const { return m_stats; } ///< print scan statistics
+
+    void setMode(app::ScanMode mode) { m_mode = mode; }
+    void setArpIo(app::ArpIo io) { m_arpIo = io; }
+    void setBatchSize(size_t size) { m_batchSize = size; }
+    void setFanout(size_t count) { m_fanout = count; }
+    void setUring(bool enable) { m_uring = enable; }
+    void setRate(uint32_t pps) { m_rate = pps; }
+    void setBurst(size_t burst) { m_burst = burst; }
+    void setPorts(const std::vector<uint16_t>& ports) { m_ports = ports; }
+    void setJobs(size_t jobs) { m_jobs = jobs; }
+    void setExcludeFile(const std::string& path) { m_excludeFile = path; }
+    void setInputFile(const std::string& path) { m_inputFile = path; }
+    void setRandomize(bool randomize) { m_randomize = randomize; }
+    void setSeed(uint64_t seed) { m_seed = seed; }
+    void setSorted(bool sorted) { m_sorted = sorted; }
+    void setShard(size_t index, size_t count)
+    {
+        m_shardIndex = index;
+        m_shardCount = count;
+    }
+    void setCheckpointFile(const std::string& path) { m_checkpointFile = path; }
+    void setResume(bool resume) { m_resume = resume; }
+    void setNeighCache(bool enable) { m_neighCache = enable; }
+    void setStats(bool stats) { m_stats = stats; }
+
+private:
+    app::ScanMode m_mode;
+    app::ArpIo m_arpIo;
+    size_t m_batchSize;
+    size_t m_fanout;
+    bool m_uring;
+    uint32_t m_rate;
+    size_t m_burst;
+    std::vector<uint16_t> m_ports;
+    size_t m_jobs;
+    std::string m_excludeFile;
+    std::string m_inputFile;
+    bool m_randomize;
+    uint64_t m_seed;
+    bool m_sorted;
+    size_t m_shardIndex;
+    size_t m_shardCount;
+    std::string m_checkpointFile;
+    bool m_resume;
+    bool m_neighCache;
+    bool m_stats;
+};
+
+} // namespace app
+
+
+#endif // IG_APPLICATION_OPTIONS_H
@@ -0,0 +1,138 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "application/result.h"
+#include "application/vendor-lookup.h"
+#include "middleware/mac-addr.h"
+#include "pipeline.h"
+
+#include <omw/cli.h>
+
+
+using std::cout;
+using std::endl;
+
+
+
+app::ResultPipeline::ResultPipeline(const app::ResultHandler& output, size_t workerCount)
+    : m_output(output), m_lookupStage("vendor lookup"), m_outputStage("output"), m_workers(workerCount > 0 ? workerCount : 1), m_outputThread(), m_closed(false)
+{
+    for (auto& th : m_workers) { th = std::thread(&ResultPipeline::lookupThread, this); }
+    m_outputThread = std::thread(&ResultPipeline::outputThread, this);
+}
+
+app::ResultPipeline::~ResultPipeline() { this->close(); }
+
+void app::ResultPipeline::submit(const app::ScanResult& result)
+{
+    if (result.empty()) { return; }
+
+    if (result.mac() == mac::Addr::null) { m_outputStage.push(result); }
+    else { m_lookupStage.push(result); }
+}
+
+void app::ResultPipeline::close()
+{
+    if (m_closed) { return; }
+    m_closed = true;
+
+    // the lookup workers push to the output stage until they've drained their queue
+    m_lookupStage.close();
+    for (auto& th : m_workers) { th.join(); }
+
+    m_outputStage.close();
+    m_outputThread.join();
+}
+
+void app::ResultPipeline::printStats() const
+{
+    cout << omw::fgBrightBlack;
+
+    for (const Stage* stage : { &m_lookupStage, &m_outputStage })
+    {
+        cout << stage->name() << " queue: " << stage->count() << " results, max depth " << stage->maxDepth() << "/" << queue_capacity;
+        if (stage->stallCount() > 0) { cout << ", " << stage->stallCount() << " times full"; }
+        if (stage == &m_lookupStage) { cout << ", " << m_workers.size() << " workers"; }
+        cout << endl;
+    }
+
+    cout << omw::fgDefault;
+}
+
+
+
+void app::ResultPipeline::lookupThread()
+{
+    app::ScanResult result;
+
+    while (m_lookupStage.pop(result))
+    {
+        result.setVendor(app::lookupVendor(result.mac()));
+        m_outputStage.push(result);
+    }
+}
+
+void app::ResultPipeline::outputThread()
+{
+    app::ScanResult result;
+
+    while (m_outputStage.pop(result)) { m_output(result); }
+}
+
+
+
+void app::ResultPipeline::Stage::push(const app::ScanResult& result)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mtx);
+
+        if (m_queue.size() >= queue_capacity)
+        {
+            ++m_stallCount;
+            m_notFull.wait(lock, [&]() { return (m_queue.size() < queue_capacity); });
+        }
+
+        m_queue.push_back(result);
+        ++m_count;
+        if (m_queue.size() > m_maxDepth) { m_maxDepth = m_queue.size(); }
+    }
+
+    m_notEmpty.notify_one();
+}
+
+bool app::ResultPipeline::Stage::pop(app::ScanResult& result)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mtx);
+        m_notEmpty.wait(lock, [&]() { return (!m_queue.empty() || m_closed); });
+
+        if (m_queue.empty()) { return false; }
+
+        result = m_queue.front();
+        m_queue.pop_front();
+    }
+
+    m_notFull.notify_one();
+
+    return true;
+}
+
+void app::ResultPipeline::Stage::close()
+{
+    {
+        std::lock_guard<std::mutex> lg(m_mtx);
+        m_closed = true;
+    }
+
+    m_notEmpty.notify_all();
+}
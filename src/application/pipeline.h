@@ -0,0 +1,127 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_APPLICATION_PIPELINE_H
+#define IG_APPLICATION_PIPELINE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "application/result.h"
+
+
+namespace app {
+
+/**
+ * @brief Stages after the probing: vendor lookup and output.
+ *
+ * The sweeps report the results without vendor. The results are looked up by a group of worker threads, and printed by
+ * the output thread in the order in which the lookups complete. The stages are connected by bounded queues, a stage
+ * blocks only if the queue of the next one is full. So a slow online lookup doesn't delay the probes, as long as the
+ * lookup queue has room.
+ *
+ * Results without MAC address, e.g. of routed ICMP or TCP probes, bypass the lookup.
+ */
+class ResultPipeline
+{
+public:
+    static constexpr size_t default_worker_count = 4;
+    static constexpr size_t queue_capacity = 1024;
+
+public:
+    /**
+     * `output` is called by the output thread only.
+     */
+    explicit ResultPipeline(const app::ResultHandler& output, size_t workerCount = default_worker_count);
+
+    virtual ~ResultPipeline();
+
+    ResultPipeline(const ResultPipeline& other) = delete;
+    ResultPipeline& operator=(const ResultPipeline& other) = delete;
+
+    /**
+     * Blocks while the queue of the next stage is full.
+     */
+    void submit(const app::ScanResult& result);
+
+    app::ResultHandler handler()
+    {
+        return [this](const app::ScanResult& result) { this->submit(result); };
+    }
+
+    /**
+     * Waits until all submitted results have been output. No results may be submitted afterwards.
+     */
+    void close();
+
+    /**
+     * Must be called after `close()`.
+     */
+    void printStats() const;
+
+private:
+    /**
+     * @brief Bounded FIFO between two stages.
+     */
+    class Stage
+    {
+    public:
+        explicit Stage(const std::string& name)
+            : m_name(name), m_queue(), m_closed(false), m_maxDepth(0), m_stallCount(0), m_count(0), m_mtx(), m_notEmpty(), m_notFull()
+        {}
+
+        virtual ~Stage() {}
+
+        /**
+         * Blocks while the queue is full.
+         */
+        void push(const app::ScanResult& result);
+
+        /**
+         * Blocks while the queue is empty. Returns `false` if the stage has been closed and the queue is empty.
+         */
+        bool pop(app::ScanResult& result);
+
+        void close();
+
+        const std::string& name() const { return m_name; }
+        size_t maxDepth() const { return m_maxDepth; }     ///< max number of queued results
+        size_t stallCount() const { return m_stallCount; } ///< number of pushes which have waited for room
+        size_t count() const { return m_count; }           ///< number of pushed results
+
+    private:
+        std::string m_name;
+        std::deque<app::ScanResult> m_queue;
+        bool m_closed;
+        size_t m_maxDepth;
+        size_t m_stallCount;
+        size_t m_count;
+        std::mutex m_mtx;
+        std::condition_variable m_notEmpty;
+        std::condition_variable m_notFull;
+    };
+
+    app::ResultHandler m_output;
+    Stage m_lookupStage;
+    Stage m_outputStage;
+    std::vector<std::thread> m_workers;
+    std::thread m_outputThread;
+    bool m_closed;
+
+    void lookupThread();
+    void outputThread();
+};
+
+} // namespace app
+
+
+#endif // IG_APPLICATION_PIPELINE_H
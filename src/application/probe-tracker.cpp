@@ -0,0 +1,110 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#include <cstddef>
+#include <cstdint>
+
+#include "middleware/ip-addr.h"
+#include "middleware/rtt-estimator.h"
+#include "probe-tracker.h"
+
+#include <omw/clock.h>
+
+
+using omw::clock::timepoint_t;
+
+
+
+app::ProbeTracker::ProbeTracker(timepoint_t initialTimeout, timepoint_t minTimeout, timepoint_t maxTimeout)
+    : m_pending(), m_timeline(), m_rtt(initialTimeout, minTimeout, maxTimeout), m_replyCount(0), m_lateReplyCount(0)
+{}
+
+void app::ProbeTracker::sent(const ip::Addr4& addr, timepoint_t now)
+{
+    m_pending[addr.value()] = Probe{ now, 1, 0 };
+    m_timeline[0].push_back(Transmission{ addr.value(), now });
+}
+
+void app::ProbeTracker::expire(timepoint_t now, const retransmit_function& retransmit, const expired_function& expired)
+{
+    const int requests = this->requestCount();
+
+    for (size_t i = 0; i < m_timeline.size(); ++i)
+    {
+        auto& queue = m_timeline[i];
+        const timepoint_t timeout = m_rtt.rto((int)i);
+
+        while (!queue.empty() && ((queue.front().time + timeout) <= now))
+        {
+            const ip::Addr4::value_type ip = queue.front().ip;
+            queue.pop_front();
+
+            const auto it = m_pending.find(ip);
+            if (it == m_pending.end()) { continue; } // has replied in the meantime
+
+            Probe& probe = it->second;
+
+            if ((probe.count + probe.failed) < requests)
+            {
+                const TxResult result = retransmit(ip::Addr4(ip));
+                if (result == TxResult::sent)
+                {
+                    probe.lastSent = now;
+                    ++probe.count;
+                }
+                else if (result == TxResult::failed) { ++probe.failed; }
+
+                // if sending failed the retransmission is tried again after the next timeout
+                m_timeline[probe.count - 1].push_back(Transmission{ ip, now });
+            }
+            else
+            {
+                m_pending.erase(it);
+                expired(ip::Addr4(ip));
+            }
+        }
+    }
+}
+
+bool app::ProbeTracker::replied(const ip::Addr4& addr, timepoint_t rxTime, timepoint_t& rtt)
+{
+    const auto it = m_pending.find(addr.value());
+    if (it == m_pending.end()) { return false; } // not a target, or already answered
+
+    rtt = (rxTime > it->second.lastSent ? rxTime - it->second.lastSent : 0);
+
+    if (it->second.count == 1) { m_rtt.addSample(rtt); }
+    else { ++m_lateReplyCount; }
+
+    ++m_replyCount;
+    m_pending.erase(it);
+
+    return true;
+}
+
+timepoint_t app::ProbeTracker::nextDeadline() const
+{
+    timepoint_t r = -1;
+
+    for (size_t i = 0; i < m_timeline.size(); ++i)
+    {
+        if (!m_timeline[i].empty())
+        {
+            const timepoint_t deadline = m_timeline[i].front().time + m_rtt.rto((int)i);
+            if ((r < 0) || (deadline < r)) { r = deadline; }
+        }
+    }
+
+    return r;
+}
+
+int app::ProbeTracker::requestCount() const
+{
+    const bool jitter = ((m_rtt.sampleCount() > 0) && (m_rtt.rttvar() > m_rtt.srtt()));
+    const bool lossy = ((m_lateReplyCount * 8) > m_replyCount);
+
+    return ((jitter || lossy) ? max_requests_per_target : requests_per_target);
+}
@@ -0,0 +1,121 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_APPLICATION_PROBETRACKER_H
+#define IG_APPLICATION_PROBETRACKER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+
+#include "middleware/ip-addr.h"
+#include "middleware/rtt-estimator.h"
+
+#include <omw/clock.h>
+
+
+namespace app {
+
+/**
+ * @brief Keeps track of the targets which have been probed but haven't replied yet.
+ *
+ * The timeouts and the number of requests per target are derived from the measured RTT. All times are in microseconds.
+ */
+class ProbeTracker
+{
+public:
+    static constexpr int requests_per_target = 2;     ///< number of requests sent to a target before it's considered offline
+    static constexpr int max_requests_per_target = 3; ///< on segments with a high jitter or loss
+
+    enum class TxResult
+    {
+        sent,
+        busy,   ///< try again after the next timeout, doesn't count as request
+        failed, ///< counts as request, so that an unreachable target is dropped after `requestCount()` attempts
+    };
+
+    /**
+     * Sends a retransmission to the target.
+     */
+    using retransmit_function = std::function<TxResult(const ip::Addr4& addr)>;
+
+    /**
+     * Called for a target which has timed out after the last request, it's dropped.
+     */
+    using expired_function = std::function<void(const ip::Addr4& addr)>;
+
+public:
+    ProbeTracker(omw::clock::timepoint_t initialTimeout, omw::clock::timepoint_t minTimeout, omw::clock::timepoint_t maxTimeout);
+    virtual ~ProbeTracker() {}
+
+    void reserve(size_t n) { m_pending.reserve(n); }
+
+    bool empty() const { return m_pending.empty(); }
+    size_t size() const { return m_pending.size(); } ///< number of targets waiting for a reply
+
+    /**
+     * Registers the first request sent to `addr`.
+     */
+    void sent(const ip::Addr4& addr, omw::clock::timepoint_t now);
+
+    /**
+     * Retransmits the requests which have timed out, and drops the targets which have received the last request.
+     */
+    void expire(omw::clock::timepoint_t now, const retransmit_function& retransmit, const expired_function& expired);
+
+    /**
+     * Returns `true` and the round trip time of the last request if `addr` is waiting for a reply, and removes it. Only
+     * the RTT of the first request is fed to the estimator, replies to retransmissions are ambiguous (Karn's algorithm).
+     */
+    bool replied(const ip::Addr4& addr, omw::clock::timepoint_t rxTime, omw::clock::timepoint_t& rtt);
+
+    /**
+     * Returns the time of the next retransmission or timeout, `-1` if there is none.
+     */
+    omw::clock::timepoint_t nextDeadline() const;
+
+    /**
+     * Number of requests sent to a target before it's considered offline. One more request is sent on segments where
+     * the RTT varies a lot (e.g. Wi-Fi stations in power save mode) or where hosts often answer a retransmission only.
+     */
+    int requestCount() const;
+
+    const RttEstimator& rtt() const { return m_rtt; }
+    size_t replyCount() const { return m_replyCount; }
+    size_t lateReplyCount() const { return m_lateReplyCount; } ///< replies which arrived after a retransmission
+
+private:
+    struct Probe
+    {
+        omw::clock::timepoint_t lastSent;
+        int count;  // number of sent requests
+        int failed; // number of requests which failed to send
+    };
+
+    struct Transmission
+    {
+        ip::Addr4::value_type ip;
+        omw::clock::timepoint_t time;
+    };
+
+    std::unordered_map<ip::Addr4::value_type, Probe> m_pending;
+
+    // One queue per request number, ordered by the time the request was sent. All requests in a queue have the same
+    // timeout, so the front always expires first, even if the timeout changes.
+    std::array<std::deque<Transmission>, max_requests_per_target> m_timeline;
+
+    RttEstimator m_rtt;
+    size_t m_replyCount;
+    size_t m_lateReplyCount;
+};
+
+} // namespace app
+
+
+#endif // IG_APPLICATION_PROBETRACKER_H
@@ -4,20 +4,43 @@ date            24.03.2025
 copyright       GPL-3.0 - Copyright (c) 2025 Oliver Blaser
 */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
+#include "application/arp-sweep.h"
+#include "application/checkpoint.h"
+#include "application/icmp-sweep.h"
+#include "application/neigh-harvest.h"
+#include "application/nd-sweep.h"
+#include "application/neigh-sweep.h"
+#include "application/options.h"
+#include "application/pipeline.h"
+#include "application/reorder-buffer.h"
 #include "application/result.h"
 #include "application/scan.h"
+#include "application/targets.h"
+#include "application/tcp-sweep.h"
+#include "middleware/addr-set.h"
 #include "middleware/cli.h"
+#include "middleware/interrupt.h"
 #include "middleware/ip-addr.h"
 #include "middleware/mac-addr.h"
+#include "middleware/mpmc-queue.h"
 #include "process.h"
 #include "project.h"
 
@@ -25,173 +48,487 @@ copyright       GPL-3.0 - Copyright (c) 2025 Oliver Blaser
 #include <omw/defs.h>
 #include <omw/string.h>
 
-#if OMW_PLAT_WIN
-#include <Windows.h>
-#else
-#include <time.h>
-#endif
-
 
 using std::cout;
 using std::endl;
 
 
 
+#if OMW_PLAT_WIN
+
+/**
+ * @brief Hand-over of the IPs to the scan threads and of the results back to the main thread.
+ *
+ * `SendARP()` blocks until the host has replied or the resolution has timed out, and there is no asynchronous variant.
+ * So the number of probes in flight is the number of scan threads. The Linux sweeps don't need threads, they are event
+ * loops over non-blocking sockets in which a probe is a `app::ProbeTracker` entry waiting for its reply or timeout.
+ *
+ * The IPs are claimed from the target generator under a mutex, the generator may read from a stream which has no random
+ * access. A claim is negligible next to a blocking scan. The results are passed through a lock-free bounded MPMC ring
+ * buffer, `m_mtx` and the condition variable only serve to wake up the main thread.
+ */
 class Queue
 {
 public:
-#if PRJ_DEBUG
-    static constexpr size_t maxThCount = 10;
-#else
-    static constexpr size_t maxThCount = 20;
-#endif
-
-    using lock_guard = std::lock_guard<std::mutex>;
+    static constexpr size_t resultCapacity = 1024;
 
 public:
     Queue()
-        : m_thCount(0)
+        : m_ip(nullptr), m_ipMtx(), m_ipDone(false), m_thCount(0), m_res(resultCapacity), m_mtx(), m_cv()
     {}
 
     virtual ~Queue() {}
 
-    void setRange(const std::vector<ip::Addr4>& range)
+    /**
+     * Must not be called while scan threads are running.
+     */
+    void setTargets(app::TargetGenerator& targets)
     {
-        lock_guard lg(mtx);
-        m_ip = range;
+        m_ip = &targets;
+        m_ipDone.store(false);
     }
 
-    app::ScanResult popRes()
+    /**
+     * Blocks until a result is available, `addr` is the scanned IP. Returns `false` if all IPs have been scanned and all
+     * results are popped.
+     */
+    bool waitRes(ip::Addr4& addr, app::ScanResult& res)
     {
-        lock_guard lg(mtx);
-        app::ScanResult res;
-        if (!m_res.empty())
+        std::unique_lock<std::mutex> lock(m_mtx);
+        std::pair<ip::Addr4, app::ScanResult> scanned;
+        bool popped = false;
+        m_cv.wait(lock, [&]() {
+            popped = m_res.pop(scanned);
+            return (popped || this->done());
+        });
+
+        if (popped)
         {
-            res = m_res.front();
-            m_res.erase(m_res.begin());
+            addr = scanned.first;
+            res = scanned.second;
         }
-        return res;
-    }
 
-    size_t thCount() const
-    {
-        lock_guard lg(mtx);
-        return m_thCount;
+        return popped;
     }
 
-    size_t remaining() const
-    {
-        lock_guard lg(mtx);
-        return m_ip.size();
-    }
+    /**
+     * Number of threads which are currently scanning an IP.
+     */
+    size_t thCount() const { return m_thCount.load(); }
 
+    /**
+     * Must only be called by the consumer of the results.
+     */
     bool done() const
     {
-        lock_guard lg(mtx);
-        return (m_ip.empty() && m_res.empty() && (m_thCount == 0));
+        // the order matters, a thread is counted before it claims an IP and uncounted after it has queued the result
+        return (m_ipDone.load() && (m_thCount.load() == 0) && m_res.empty());
     }
 
 public: // thread internal
-    ip::Addr4 popIP()
+    /**
+     * Returns `false` if there are no IPs left.
+     */
+    bool popIP(ip::Addr4& ip)
     {
-        lock_guard lg(mtx);
         ++m_thCount;
-        const ip::Addr4 ip = m_ip.front();
-        m_ip.erase(m_ip.begin());
-        return ip;
+
+        bool more;
+        while (true)
+        {
+            bool stalled;
+            {
+                std::lock_guard<std::mutex> lg(m_ipMtx);
+                more = (!m_ipDone.load() && m_ip->next(ip));
+                stalled = (!more && !m_ipDone.load() && m_ip->stalled());
+                if (!more && !stalled) { m_ipDone.store(true); }
+            }
+
+            if (!stalled) { break; }
+
+            // the scan threads block anyway, they wait until the stream provides more IPs
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        if (!more)
+        {
+            --m_thCount;
+            this->notify(); // the main thread may have seen this thread counted
+        }
+
+        return more;
     }
 
-    void queueRes(const app::ScanResult& res)
+    /**
+     * Waits while the result buffer is full. Every IP gets a result, which is empty if the IP hasn't replied.
+     */
+    void queueRes(const ip::Addr4& addr, const app::ScanResult& res)
     {
-        lock_guard lg(mtx);
+        while (!m_res.push(std::make_pair(addr, res))) { std::this_thread::yield(); }
         --m_thCount;
-        m_res.push_back(res);
+        this->notify();
     }
 
 private:
-    mutable std::mutex mtx;
-    size_t m_thCount;
-    std::vector<ip::Addr4> m_ip;
-    std::vector<app::ScanResult> m_res;
+    app::TargetGenerator* m_ip;
+    std::mutex m_ipMtx;
+    std::atomic<bool> m_ipDone;
+    std::atomic<size_t> m_thCount;
+    MpmcQueue<std::pair<ip::Addr4, app::ScanResult>> m_res;
+
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+
+    void notify()
+    {
+        // taking the mutex ensures that the main thread either hasn't checked yet or is already waiting
+        {
+            std::lock_guard<std::mutex> lg(m_mtx);
+        }
+
+        m_cv.notify_one();
+    }
 };
 
 
 
 static Queue queue;
 
+static size_t workerCount(const app::Options& options, size_t targetCount);
+static void scanThread();
+
+#endif // OMW_PLAT_WIN
+
 
 
-static void scanThread();
 static void printMaskAssumeInfo(const ip::SubnetMask4& mask);
 static void printResult(const app::ScanResult& result);
-static int getRange(std::vector<ip::Addr4>& range, const std::string& argAddrRange);
+static int parseRange(const std::string& argAddrRange, ip::Addr4& start, ip::Addr4::value_type& count, ip::SubnetMask4& mask);
+static int getRange(app::TargetRange& range, const std::string& argAddrRange);
+static int getSpan(const std::string& argAddrRange, ip::Addr4& first, ip::Addr4& last);
+static int getExclusion(ip::AddrSet4& excluded, const std::string& argAddrRange);
+static int loadExcludeFile(ip::AddrSet4& excluded, const std::string& path);
+static int processIPv4(app::TargetGenerator& range, const ip::AddrSet4& included, const app::Options& options, uint64_t& position, bool& interrupted);
+static int processIPv6(const std::vector<std::string>& args, const app::Options& options);
 
 
 
-int app::process(const std::string& argAddrRange)
+int app::process(const std::vector<std::string>& args, const app::Options& options)
 {
-    std::vector<ip::Addr4> range;
-    const int err = getRange(range, argAddrRange);
-    if (err) { return -(__LINE__); }
+    int r = 0;
 
-    if (range.empty())
+    // a resumed sweep has to generate the same targets in the same order
+    const std::string fingerprint = app::Checkpoint::fingerprintOf(args, options);
+    app::Checkpoint resumeFrom;
+    if (options.resume())
     {
-        cli::printError("empty IP address range");
-        return -(__LINE__);
+        const int err = resumeFrom.read(options.checkpointFile());
+        if (err) { return -(__LINE__); }
+
+        if (resumeFrom.fingerprint() != fingerprint)
+        {
+            cli::printError("the checkpoint \"" + options.checkpointFile() + "\" is of a sweep with other arguments");
+            return -(__LINE__);
+        }
     }
+    const uint64_t seed = (options.resume() ? resumeFrom.seed() : options.seed());
+    uint64_t position = resumeFrom.position();
+    bool interrupted = false;
+
+    ip::AddrSet4 included;
+    ip::AddrSet4 excluded;
+    size_t rangeCount = 0;
+    bool exclusionErr = false;
+    std::vector<std::string> args6;
+
+    // all ranges are swept at once, so that the slowest host of one range doesn't hold up the others
+    for (const auto& argAddrRange : args)
+    {
+        if (argAddrRange.find(':') != std::string::npos)
+        {
+            args6.push_back(argAddrRange);
+            continue;
+        }
 
-    queue.setRange(range);
+        if (argAddrRange[0] == '!')
+        {
+            const int err = getExclusion(excluded, argAddrRange.substr(1));
+            if (err) { exclusionErr = true; }
+            continue;
+        }
 
+        app::TargetRange range;
+        const int err = getRange(range, argAddrRange);
+        if (err) { r = -(__LINE__); }
+        else if (range.empty())
+        {
+            cli::printError("empty IP address range");
+            r = -(__LINE__);
+        }
+        else
+        {
+            range.addTo(included);
+            ++rangeCount;
+        }
+    }
 
+    if (!options.excludeFile().empty())
+    {
+        const int err = loadExcludeFile(excluded, options.excludeFile());
+        if (err) { exclusionErr = true; }
+    }
 
-    cout << endl;
+    // the target list is only opened here, it's read while scanning
+    std::shared_ptr<std::istream> input;
+    std::string inputName;
+    if (options.inputFile() == "-")
+    {
+        input = std::shared_ptr<std::istream>(&std::cin, [](std::istream*) {}); // not owned
+        inputName = "stdin";
+    }
+    else if (!options.inputFile().empty())
+    {
+        const auto inputFile = std::make_shared<std::ifstream>(options.inputFile());
+        if (inputFile->good())
+        {
+            input = inputFile;
+            inputName = options.inputFile();
+        }
+        else
+        {
+            cli::printError("failed to open input file \"" + options.inputFile() + "\"");
+            r = -(__LINE__);
+        }
+    }
+
+    // the excluded hosts may be sensitive, rather scan nothing than scan them because of a typo
+    if (exclusionErr)
+    {
+        cli::printError("invalid exclusion, the IPv4 ranges are not scanned");
+        r = -(__LINE__);
+    }
+    else if ((rangeCount > 0) || input)
+    {
+        included.normalize();
+        excluded.normalize();
+
+        const uint64_t total = included.size();
+        included.subtract(excluded);
+
+        app::TargetSet targets(included);
 
-    do {
-        const size_t thCount = queue.thCount();
-        if ((queue.remaining() != 0) && (thCount < Queue::maxThCount))
+        // the permutation is computed per index, the order costs no memory
+        app::TargetPermutation permutation(targets, seed);
+        app::TargetGenerator& ordered = (options.randomize() ? (app::TargetGenerator&)permutation : (app::TargetGenerator&)targets);
+
+        if ((rangeCount > 1) || ((rangeCount > 0) && !excluded.empty()))
         {
-            std::thread th(scanThread);
-            th.detach();
-            while (queue.thCount() == thCount) {} // wait until the thread has started and popped the IP
+            cout << "scanning " << targets.size() << " IPs in total";
+            if (targets.size() < total) { cout << ", " << (total - targets.size()) << " excluded"; }
+            cout << endl;
         }
 
-        uint16_t sleep_ms = 100;
-        const auto res = queue.popRes();
-        if (!res.empty())
+        if (options.randomize() && (rangeCount > 0)) { cout << "random order, seed " << seed << endl; }
+        if (options.shardCount() > 1) { cout << "scanning shard " << (options.shardIndex() + 1) << "/" << options.shardCount() << endl; }
+        if (position > 0) { cout << "resuming after " << position << " IPs" << endl; }
+
+        if (input)
         {
-            printResult(res);
-            sleep_ms = 1;
+            cout << "scanning the IPs listed in " << omw::fgBrightWhite << inputName << omw::fgDefault << endl;
+
+            // the listed targets follow the ones of the arguments, exclusions are applied per address
+            app::TargetStream stream(input, inputName, excluded);
+            app::TargetChain chain(ordered, stream);
+
+            const int err = processIPv4(chain, included, options, position, interrupted);
+            if (err) { r = -(__LINE__); }
+
+            cout << "read " << stream.entryCount() << " entries of " << omw::fgBrightWhite << inputName << omw::fgDefault;
+            if (stream.excludedCount() > 0) { cout << ", " << stream.excludedCount() << " IPs excluded"; }
+            cout << endl;
+
+            if (stream.errorCount() > 0)
+            {
+                cli::printError(std::to_string(stream.errorCount()) + " invalid entries in " + inputName);
+                r = -(__LINE__);
+            }
+        }
+        else if (targets.empty())
+        {
+            cli::printError("all addresses are excluded");
+            r = -(__LINE__);
+        }
+        else
+        {
+            const int err = processIPv4(ordered, included, options, position, interrupted);
+            if (err) { r = -(__LINE__); }
         }
 
-#if OMW_PLAT_WIN
-        Sleep(sleep_ms);
-#else
-        struct timespec ts;
-        ts.tv_sec = 0;
-        ts.tv_nsec = ((int32_t)sleep_ms * 1000);
-        nanosleep(&ts, NULL);
-#endif
+        if (interrupted)
+        {
+            const int err = app::Checkpoint(fingerprint, seed, position).write(options.checkpointFile());
+            if (err == 0)
+            {
+                cout << "interrupted after " << position << " IPs, continue the sweep with the same arguments and --resume" << endl;
+                cout << "checkpoint written to " << omw::fgBrightWhite << options.checkpointFile() << omw::fgDefault << endl;
+            }
+
+            r = -(__LINE__);
+        }
+        else if (options.resume() && (r == 0)) { std::remove(options.checkpointFile().c_str()); }
+    }
+
+    if (!args6.empty() && !interrupted)
+    {
+        const int err = processIPv6(args6, options);
+        if (err) { r = -(__LINE__); }
+    }
+
+    return r;
+}
+
+
+
+/**
+ * @param included The addresses of the ADDR arguments without the exclusions, the targets of `range` except the ones of
+ * a target list
+ */
+int processIPv4(app::TargetGenerator& range, const ip::AddrSet4& included, const app::Options& options, uint64_t& position, bool& interrupted)
+{
+    // the other shards are scanned by other instances, no coordination is needed
+    app::TargetShard shard(range, options.shardIndex(), options.shardCount());
+
+    // stops generating targets on SIGINT, the sweep drains the probes which are in flight
+    app::TargetCursor targets(shard);
+    if (!targets.skip(position))
+    {
+        cli::printError("the checkpoint is beyond the end of the targets");
+        return -(__LINE__);
     }
-    while (!queue.done());
 
     cout << endl;
 
+    // holds the results back until the lower targets have finished, so the output is in the target order
+    app::ReorderBuffer reorder(targets, printResult);
+    app::TargetGenerator& generated = (options.sorted() ? (app::TargetGenerator&)reorder : (app::TargetGenerator&)targets);
+
+    // the vendors are looked up and the results printed while the sweep goes on probing
+    app::ResultPipeline pipeline(options.sorted() ? reorder.handler() : app::ResultHandler(printResult));
+    app::ResultHandler handler = pipeline.handler();
+
+    // the reorder buffer counts the results before the lookup, it waits for them when their target has finished
+    if (options.sorted())
+    {
+        handler = [&reorder, &pipeline](const app::ScanResult& result) {
+            reorder.expect(result);
+            pipeline.submit(result);
+        };
+    }
+    int sweepErr = 0;
+
+#if OMW_PLAT_WIN
+
+    (void)included;
+
+    queue.setTargets(generated);
+
+    // the workers live until all IPs are scanned or the scan is interrupted
+    std::vector<std::thread> workers(workerCount(options, generated.size()));
+    for (auto& th : workers) { th = std::thread(scanThread); }
+
+    // each result is passed on as soon as it's queued, the main thread sleeps in between
+    ip::Addr4 addr;
+    app::ScanResult res;
+    while (queue.waitRes(addr, res))
+    {
+        handler(res);
+        generated.finished(addr);
+    }
+
+    for (auto& th : workers) { th.join(); }
+
+#else // OMW_PLAT_WIN
+
+    // Hosts which are in the neighbour table don't need to be probed. They're reported before probing if they're targets
+    // of this sweep for sure, otherwise when they're reached: if the targets are sharded or resumed, or if the output is
+    // sorted.
+    const bool reportNow = ((options.shardCount() == 1) && (position == 0) && !options.sorted());
+    app::NeighbourHarvest harvest(generated, handler);
+    if (options.neighCache())
+    {
+        (void)harvest.load([&](const ip::Addr4& addr) { return (reportNow && included.contains(addr)); });
+    }
+
+    // the targets are generated as they're sent and the results are passed on as the replies arrive
+    switch (options.mode())
+    {
+    case app::ScanMode::arp:
+        sweepErr = app::arpSweep(harvest, handler, options);
+        break;
 
+    case app::ScanMode::neigh:
+        sweepErr = app::neighSweep(harvest, handler, options);
+        break;
+
+    case app::ScanMode::icmp:
+        sweepErr = app::icmpSweep(harvest, handler, options);
+        break;
+
+    case app::ScanMode::tcp:
+        sweepErr = app::tcpSweep(harvest, handler, options);
+        break;
+    }
+
+#endif // OMW_PLAT_WIN
+
+    pipeline.close();
+    if (options.sorted()) { reorder.flush(); }
+
+    if (options.stats())
+    {
+        pipeline.printStats();
+        if (options.sorted()) { reorder.printStats(); }
+    }
+
+    if (sweepErr) { return -(__LINE__); }
+
+    position = targets.position();
+    interrupted = targets.interrupted();
+
+    cout << endl;
 
     return 0;
 }
 
 
 
+#if OMW_PLAT_WIN
+size_t workerCount(const app::Options& options, size_t targetCount)
+{
+    size_t n = options.jobs();
+
+    if (n == 0)
+    {
+        const size_t cores = std::thread::hardware_concurrency();
+        n = (cores > 0 ? cores : 1) * app::Options::jobs_per_core;
+    }
+
+    return std::min(n, targetCount);
+}
+
 void scanThread()
 {
-    const auto ip = queue.popIP();
+    ip::Addr4 ip;
 
-    THREAD_PRINT(ip.toString());
+    while (queue.popIP(ip))
+    {
+        THREAD_PRINT(ip.toString());
 
-    const auto res = app::scan(ip);
-    queue.queueRes(res);
+        const auto res = app::scan(ip);
+        queue.queueRes(ip, res);
+    }
 }
+#endif // OMW_PLAT_WIN
 
 void printMaskAssumeInfo(const ip::SubnetMask4& mask)
 {
@@ -210,13 +547,22 @@ void printResult(const app::ScanResult& result)
 {
     std::stringstream ss;
 
-    ss << " " << std::left << std::setw(15) << result.ip().toString();
+    if (result.isIPv6()) { ss << " " << std::left << std::setw(25) << result.ip6().toString(); }
+    else { ss << " " << std::left << std::setw(15) << result.ip().toString(); }
 
-    if (result.mac().isCID()) { ss << omw::fgYellow; }
-    ss << "  " << std::left << std::setw(17) << result.mac().toString();
-    ss << omw::fgDefault;
+    if (result.mac() == mac::Addr::null) { ss << "  " << std::setw(17) << ""; } // not resolved, e.g. routed ICMP results
+    else
+    {
+        if (result.mac().isCID()) { ss << omw::fgYellow; }
+        ss << "  " << std::left << std::setw(17) << result.mac().toString();
+        ss << omw::fgDefault;
+    }
+
+    if (result.cached()) { ss << "  " << omw::fgBrightBlack << "cached" << omw::fgDefault; }
+    else if (result.duration() == app::ScanResult::no_duration) { ss << "  " << std::setw(6) << ""; } // e.g. only seen by neighbour discovery
+    else { ss << "  " << std::right << std::setw(4) << result.duration() << "ms"; }
 
-    ss << "  " << std::right << std::setw(4) << result.duration() << "ms";
+    if (result.port() != 0) { ss << "  tcp/" << result.port(); }
 
     const auto& vendor = result.vendor();
     if (!vendor.empty())
@@ -235,12 +581,10 @@ void printResult(const app::ScanResult& result)
     cout << ss.str() << std::flush;
 }
 
-int getRange(std::vector<ip::Addr4>& range, const std::string& argAddrRange)
+int parseRange(const std::string& argAddrRange, ip::Addr4& start, ip::Addr4::value_type& count, ip::SubnetMask4& mask)
 {
-    ip::Addr4 start;
-    ip::Addr4::value_type count = 0;
-
-    ip::SubnetMask4 mask = ip::SubnetMask4::max;
+    count = 0;
+    mask = ip::SubnetMask4::max;
 
     const size_t slashPos = argAddrRange.find('/');
     const size_t hyphenPos = argAddrRange.find('-');
@@ -350,33 +694,31 @@ int getRange(std::vector<ip::Addr4>& range, const std::string& argAddrRange)
         return -(__LINE__);
     }
 
+    return 0;
+}
+
+int getRange(app::TargetRange& range, const std::string& argAddrRange)
+{
+    ip::Addr4 start;
+    ip::Addr4::value_type count;
+    ip::SubnetMask4 mask;
+
+    const int err = parseRange(argAddrRange, start, count, mask);
+    if (err) { return -(__LINE__); }
+
 
 
     // create range
 
     const ip::SubnetMask4& netMask = mask;
-    const ip::Addr4 hostMask = mask.hostMask();
 
 #if PRJ_DEBUG && 0
     cout << "start: " << ip::cidrString(start, netMask) << endl;
     cout << "count: " << count << endl;
 #endif
 
-    range.clear();
-    range.reserve(count);
-
-    for (uint32_t i = 0; i < count; ++i)
-    {
-        const auto addr = ip::Addr4(start.value() + i);
-
-        if (((addr & hostMask) != ip::Addr4::null) && ((addr & hostMask) != hostMask)) { range.push_back(addr); }
-        else
-        {
-#if PRJ_DEBUG && 0
-            cout << "skipping " << addr.toString() << endl;
-#endif
-        }
-    }
+    // the network and broadcast addresses are skipped by the range
+    range = app::TargetRange(start, count, netMask);
 
 
 
@@ -384,8 +726,8 @@ int getRange(std::vector<ip::Addr4>& range, const std::string& argAddrRange)
 
     if (range.size() > 1)
     {
-        const auto& first = range.front();
-        const auto& last = range.back();
+        const auto first = range.front();
+        const auto last = range.back();
 
         cout << "scanning " << range.size() << " IPs from ";
         cout << omw::fgBrightWhite << ip::cidrString(first, netMask) << omw::fgDefault;
@@ -396,7 +738,7 @@ int getRange(std::vector<ip::Addr4>& range, const std::string& argAddrRange)
     else if (!range.empty())
     {
         cout << "scanning IP ";
-        cout << omw::fgBrightWhite << range[0].toString() << omw::fgDefault;
+        cout << omw::fgBrightWhite << range.front().toString() << omw::fgDefault;
         cout << endl;
     }
 
@@ -407,8 +749,8 @@ int getRange(std::vector<ip::Addr4>& range, const std::string& argAddrRange)
         ip::Addr4 last = ip::Addr4::null;
         for (size_t i = 0; i < range.size(); ++i)
         {
-            const auto& addr = range[i];
-            const auto& next = (i < (range.size() - 1) ? range[i + 1] : ip::Addr4::max);
+            const auto addr = range.at(i);
+            const auto next = (i < (range.size() - 1) ? range.at(i + 1) : ip::Addr4::max);
 
             if (((addr.value() - last.value()) > 1) || ((next.value() - addr.value()) > 1) || (i == (range.size() - 1)))
             {
@@ -424,3 +766,159 @@ int getRange(std::vector<ip::Addr4>& range, const std::string& argAddrRange)
 
     return 0;
 }
+
+/**
+ * Unlike for targets the whole span is returned, including the network and broadcast addresses of the mask.
+ */
+int getSpan(const std::string& argAddrRange, ip::Addr4& first, ip::Addr4& last)
+{
+    ip::Addr4::value_type count;
+    ip::SubnetMask4 mask;
+
+    const int err = parseRange(argAddrRange, first, count, mask);
+    if (err) { return -(__LINE__); }
+
+    const uint64_t n = (count == 0 ? ((uint64_t)1 << ip::Addr4::bit_count) : count); // `count` overflows on /0
+    last = ip::Addr4((ip::Addr4::value_type)std::min<uint64_t>((uint64_t)first.value() + n - 1, ip::Addr4::max.value()));
+
+    return 0;
+}
+
+int getExclusion(ip::AddrSet4& excluded, const std::string& argAddrRange)
+{
+    ip::Addr4 start, last;
+
+    const int err = getSpan(argAddrRange, start, last);
+    if (err) { return -(__LINE__); }
+
+    excluded.add(start, last);
+
+    if (start == last) { cout << "excluding IP " << omw::fgBrightWhite << start.toString() << omw::fgDefault << endl; }
+    else
+    {
+        cout << "excluding " << ((uint64_t)last.value() - start.value() + 1) << " IPs from ";
+        cout << omw::fgBrightWhite << start.toString() << omw::fgDefault;
+        cout << " to ";
+        cout << omw::fgBrightWhite << last.toString() << omw::fgDefault;
+        cout << endl;
+    }
+
+    return 0;
+}
+
+/**
+ * One address, subnet or range per line, in the same format as the ADDR arguments. Everything after a `#` is a comment.
+ */
+int loadExcludeFile(ip::AddrSet4& excluded, const std::string& path)
+{
+    std::ifstream ifs(path);
+    if (!ifs.good())
+    {
+        cli::printError("failed to open exclude file \"" + path + "\"");
+        return -(__LINE__);
+    }
+
+    std::string line;
+    size_t lineNumber = 0;
+    size_t entryCount = 0;
+
+    while (std::getline(ifs, line))
+    {
+        ++lineNumber;
+
+        const size_t commentPos = line.find('#');
+        if (commentPos != std::string::npos) { line.erase(commentPos); }
+
+        const size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos) { continue; }
+        const size_t last = line.find_last_not_of(" \t\r");
+        const std::string entry = line.substr(first, last - first + 1);
+
+        ip::Addr4 start, end;
+
+        const int err = getSpan(entry, start, end);
+        if (err)
+        {
+            cli::printError(path + ":" + std::to_string(lineNumber) + ": invalid entry \"" + entry + "\"");
+            return -(__LINE__);
+        }
+
+        excluded.add(start, end);
+        ++entryCount;
+    }
+
+    cout << "excluding " << entryCount << " entries of " << omw::fgBrightWhite << path << omw::fgDefault << endl;
+
+    return 0;
+}
+
+int processIPv6(const std::vector<std::string>& args, const app::Options& options)
+{
+    struct Prefix
+    {
+        ip::Addr6 network;
+        ip::SubnetMask6 mask;
+    };
+
+    std::vector<Prefix> prefixes;
+    int r = 0;
+
+    for (const auto& argAddrRange : args)
+    {
+        ip::Addr6 prefix;
+        ip::SubnetMask6 mask(64);
+
+        try
+        {
+            const size_t slashPos = argAddrRange.find('/');
+
+            prefix = argAddrRange.substr(0, slashPos);
+            if (slashPos != std::string::npos) { mask = argAddrRange.substr(slashPos); }
+        }
+        catch (const std::exception& ex)
+        {
+            cli::printError("invalid IPv6 prefix", ex.what());
+            r = -(__LINE__);
+            continue;
+        }
+
+        cout << "discovering IPv6 hosts in " << omw::fgBrightWhite << ip::cidrString(prefix & mask, mask) << omw::fgDefault << endl;
+
+        prefixes.push_back(Prefix{ prefix & mask, mask });
+    }
+
+    if (prefixes.empty()) { return r; }
+
+    cout << endl;
+
+#if OMW_PLAT_WIN
+
+    (void)options;
+
+    cli::printError("IPv6 discovery is only implemented for Linux");
+    return -(__LINE__);
+
+#else // OMW_PLAT_WIN
+
+    app::ResultPipeline pipeline(printResult);
+
+    // one discovery serves all prefixes, the hosts are filtered afterwards
+    const auto handler = [&prefixes, &pipeline](const app::ScanResult& result) {
+        if (std::any_of(prefixes.begin(), prefixes.end(), [&result](const Prefix& p) { return ((result.ip6() & p.mask) == p.network); }))
+        {
+            pipeline.submit(result);
+        }
+    };
+
+    const int err = app::ndSweep(ip::Addr6::null, ip::SubnetMask6(0), handler, options);
+    pipeline.close();
+    if (err) { return -(__LINE__); }
+
+    if (options.stats()) { pipeline.printStats(); }
+
+    cout << endl;
+
+    return r;
+
+#endif // OMW_PLAT_WIN
+}
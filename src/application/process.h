@@ -8,11 +8,18 @@ copyright       GPL-3.0 - Copyright (c) 2025 Oliver Blaser
 #define IG_APPLICATION_PROCESS_H
 
 #include <string>
+#include <vector>
+
+#include "application/options.h"
 
 
 namespace app {
 
-int process(const std::string& argAddrRange);
+/**
+ * Scans the addresses of all ADDR arguments `args` in one sweep, and discovers the hosts of the IPv6 prefixes among
+ * them. Invalid arguments are reported and skipped. Returns 0 if all arguments have been processed successfully.
+ */
+int process(const std::vector<std::string>& args, const app::Options& options);
 
 }
 
@@ -0,0 +1,148 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+
+#include "application/result.h"
+#include "application/targets.h"
+#include "middleware/ip-addr.h"
+#include "reorder-buffer.h"
+
+#include <omw/cli.h>
+
+
+using std::cout;
+using std::endl;
+
+
+
+app::ReorderBuffer::ReorderBuffer(app::TargetGenerator& targets, const app::ResultHandler& output)
+    : m_targets(targets),
+      m_output(output),
+      m_mtx(),
+      m_base(0),
+      m_forced(0),
+      m_window(),
+      m_positions(),
+      m_results(),
+      m_maxWindow(0),
+      m_maxResults(0),
+      m_lateCount(0)
+{}
+
+bool app::ReorderBuffer::next(ip::Addr4& addr)
+{
+    if (!m_targets.next(addr)) { return false; }
+
+    std::lock_guard<std::mutex> lg(m_mtx);
+
+    const uint64_t position = m_base + m_window.size();
+    m_window.push_back(Target{ addr.value(), 0, false });
+    m_maxWindow = std::max(m_maxWindow, m_window.size());
+
+    // the results of a target which is generated twice are taken by the last position, the earlier one is done
+    const auto it = m_positions.find(addr.value());
+    if (it != m_positions.end())
+    {
+        Target& earlier = m_window[it->second - m_base];
+        m_window.back().expected = earlier.expected;
+        earlier.expected = 0;
+        earlier.finished = true;
+        it->second = position;
+    }
+    else { m_positions.emplace(addr.value(), position); }
+
+    if (m_window.size() > max_window) { this->release(false); }
+
+    return true;
+}
+
+void app::ReorderBuffer::finished(const ip::Addr4& addr)
+{
+    std::lock_guard<std::mutex> lg(m_mtx);
+
+    const auto it = m_positions.find(addr.value());
+    if (it == m_positions.end()) { return; } // has been settled already
+
+    m_window[it->second - m_base].finished = true;
+
+    this->release(false);
+}
+
+void app::ReorderBuffer::expect(const app::ScanResult& result)
+{
+    if (result.empty()) { return; } // not passed on
+
+    std::lock_guard<std::mutex> lg(m_mtx);
+
+    const auto it = m_positions.find(result.ip().value());
+    if (it != m_positions.end()) { ++(m_window[it->second - m_base].expected); }
+}
+
+void app::ReorderBuffer::add(const app::ScanResult& result)
+{
+    std::lock_guard<std::mutex> lg(m_mtx);
+
+    const auto it = m_positions.find(result.ip().value());
+    if (it == m_positions.end())
+    {
+        // the target has already been settled, or it's not one of the targets at all
+        ++m_lateCount;
+        m_output(result);
+        return;
+    }
+
+    Target& target = m_window[it->second - m_base];
+    if (target.expected > 0) { --target.expected; }
+
+    m_results.emplace(it->second, result);
+    m_maxResults = std::max(m_maxResults, m_results.size());
+
+    this->release(false);
+}
+
+void app::ReorderBuffer::flush()
+{
+    std::lock_guard<std::mutex> lg(m_mtx);
+    this->release(true);
+}
+
+void app::ReorderBuffer::printStats() const
+{
+    cout << omw::fgBrightBlack;
+    cout << "sorted output: max " << m_maxWindow << " targets in the window, max " << m_maxResults << " results held back";
+    if (m_lateCount > 0) { cout << ", " << m_lateCount << " results out of order"; }
+    cout << omw::fgDefault << endl;
+}
+
+
+
+void app::ReorderBuffer::release(bool all)
+{
+    const uint64_t end = m_base + m_window.size();
+    if (all) { m_forced = end; }
+    else if (m_window.size() > max_window) { m_forced = std::max(m_forced, end - max_window); }
+
+    while (!m_window.empty())
+    {
+        const Target& target = m_window.front();
+        const bool settled = (target.finished && (target.expected == 0));
+
+        if (!settled && (m_base >= m_forced)) { break; }
+
+        for (auto it = m_results.begin(); (it != m_results.end()) && (it->first == m_base); it = m_results.erase(it)) { m_output(it->second); }
+
+        const auto pos = m_positions.find(target.ip);
+        if ((pos != m_positions.end()) && (pos->second == m_base)) { m_positions.erase(pos); }
+
+        m_window.pop_front();
+        ++m_base;
+    }
+}
@@ -0,0 +1,113 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_APPLICATION_REORDERBUFFER_H
+#define IG_APPLICATION_REORDERBUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+#include "application/result.h"
+#include "application/targets.h"
+#include "middleware/ip-addr.h"
+
+
+namespace app {
+
+/**
+ * @brief Passes the results on in the order of the targets, while the sweep is running.
+ *
+ * The targets are passed through and numbered by their position. A result is held back until every target at a lower
+ * position is settled, i.e. the sweep has reported it as finished and its results have passed the stages in between.
+ * So the buffer only holds the targets which are in flight or queued for sending, independent of the number of
+ * targets.
+ *
+ * The results are counted by `expect()` when the sweep reports them, before the vendor lookup, and arrive at `add()`
+ * after it. A target is settled once it's finished and all its expected results have arrived.
+ *
+ * The window is limited to `max_window` targets as well, the oldest ones are considered settled if it's full. A result
+ * which arrives after its target has been settled is passed on out of order.
+ *
+ * `next()`, `finished()`, `expect()` and `handler()` may be called by different threads, the output is called by the
+ * ones of `finished()` and `handler()`.
+ */
+class ReorderBuffer : public app::TargetGenerator
+{
+public:
+    static constexpr size_t max_window = 1024 * 1024;
+
+public:
+    ReorderBuffer(app::TargetGenerator& targets, const app::ResultHandler& output);
+    virtual ~ReorderBuffer() {}
+
+    ReorderBuffer(const ReorderBuffer& other) = delete;
+    ReorderBuffer& operator=(const ReorderBuffer& other) = delete;
+
+    virtual bool next(ip::Addr4& addr);
+    virtual bool stalled() const { return m_targets.stalled(); }
+    virtual void finished(const ip::Addr4& addr);
+    virtual size_t size() const { return m_targets.size(); }
+
+    /**
+     * Must be called for every result before it's passed to the stages in between, by the thread which reports the
+     * target as finished afterwards.
+     */
+    void expect(const app::ScanResult& result);
+
+    void add(const app::ScanResult& result);
+
+    app::ResultHandler handler()
+    {
+        return [this](const app::ScanResult& result) { this->add(result); };
+    }
+
+    /**
+     * Passes all held back results on, must be called when the sweep has finished.
+     */
+    void flush();
+
+    /**
+     * Must be called after `flush()`.
+     */
+    void printStats() const;
+
+private:
+    struct Target
+    {
+        ip::Addr4::value_type ip;
+        uint32_t expected; // results which have been reported but haven't arrived yet
+        bool finished;
+    };
+
+    app::TargetGenerator& m_targets;
+    app::ResultHandler m_output;
+    std::mutex m_mtx;
+
+    uint64_t m_base;             // position of the first target in the window
+    uint64_t m_forced;           // the targets below this position are considered settled, the window has overflowed
+    std::deque<Target> m_window; // targets from `m_base` on
+
+    // position of the targets in the window, the last one if a target is generated twice
+    std::unordered_map<ip::Addr4::value_type, uint64_t> m_positions;
+
+    // held back results by position, a target may have multiple (e.g. open TCP ports)
+    std::multimap<uint64_t, app::ScanResult> m_results;
+
+    size_t m_maxWindow;
+    size_t m_maxResults;
+    size_t m_lateCount;
+
+    void release(bool all);
+};
+
+} // namespace app
+
+
+#endif // IG_APPLICATION_REORDERBUFFER_H
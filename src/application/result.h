@@ -9,6 +9,7 @@ copyright       GPL-3.0 - Copyright (c) 2025 Oliver Blaser
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <string>
 
 #include "middleware/ip-addr.h"
@@ -54,31 +55,50 @@ private:
 
 class ScanResult
 {
+public:
+    static constexpr uint32_t no_duration = UINT32_MAX; ///< the host has been seen, but hasn't answered a probe
+
 public:
     ScanResult()
-        : m_ip(ip::Addr4::null), m_mac(), m_duration(0), m_vendor()
+        : m_ip(ip::Addr4::null), m_ip6(), m_ipv6(false), m_mac(), m_duration(0), m_vendor(), m_cached(false), m_port(0)
+    {}
+
+    ScanResult(const ip::Addr4& ip, const mac::Addr& mac, uint32_t duration_ms, const Vendor& vendor, bool cached = false, uint16_t port = 0)
+        : m_ip(ip), m_ip6(), m_ipv6(false), m_mac(mac), m_duration(duration_ms), m_vendor(vendor), m_cached(cached), m_port(port)
     {}
 
-    ScanResult(const ip::Addr4& ip, const mac::Addr& mac, uint32_t duration_ms, const Vendor& vendor)
-        : m_ip(ip), m_mac(mac), m_duration(duration_ms), m_vendor(vendor)
+    ScanResult(const ip::Addr6& ip, const mac::Addr& mac, uint32_t duration_ms, const Vendor& vendor)
+        : m_ip(ip::Addr4::null), m_ip6(ip), m_ipv6(true), m_mac(mac), m_duration(duration_ms), m_vendor(vendor), m_cached(false), m_port(0)
     {}
 
     virtual ~ScanResult() {}
 
-    const ip::Addr4& ip() const { return m_ip; }
+    const ip::Addr4& ip() const { return m_ip; }   ///< null for IPv6 results
+    const ip::Addr6& ip6() const { return m_ip6; } ///< only set for IPv6 results
+    bool isIPv6() const { return m_ipv6; }
     const mac::Addr& mac() const { return m_mac; }
-    uint32_t duration() const { return m_duration; } ///< [ms]
+    uint32_t duration() const { return m_duration; } ///< [ms], `no_duration` if unknown
     const Vendor& vendor() const { return m_vendor; }
+    bool cached() const { return m_cached; } ///< taken from the neighbour table instead of being probed, duration is 0
+    uint16_t port() const { return m_port; }  ///< TCP port which has answered, 0 if not probed by TCP
+
+    bool empty() const { return ((m_ip == ip::Addr4::null) && !m_ipv6); }
 
-    bool empty() const { return (m_ip == ip::Addr4::null); }
+    void setVendor(const Vendor& vendor) { m_vendor = vendor; }
 
 private:
     ip::Addr4 m_ip;
+    ip::Addr6 m_ip6;
+    bool m_ipv6;
     mac::Addr m_mac;
     uint32_t m_duration; // [ms]
     Vendor m_vendor;
+    bool m_cached;
+    uint16_t m_port;
 };
 
+using ResultHandler = std::function<void(const app::ScanResult&)>;
+
 } // namespace app
 
 
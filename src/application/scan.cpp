@@ -8,7 +8,6 @@ copyright       GPL-3.0 - Copyright (c) 2025 Oliver Blaser
 #include <cstdint>
 
 #include "application/result.h"
-#include "application/vendor-lookup.h"
 #include "middleware/cli.h"
 #include "middleware/ip-addr.h"
 #include "middleware/mac-addr.h"
@@ -82,7 +81,7 @@ app::ScanResult impl_scan(const ip::Addr4& addr)
             else { mac[i] = 0; }
         }
 
-        r = app::ScanResult(addr, mac, (uint32_t)((dur_us + 500) / 1000), app::lookupVendor(mac));
+        r = app::ScanResult(addr, mac, (uint32_t)((dur_us + 500) / 1000), app::Vendor());
     }
     else
     {
@@ -160,41 +159,17 @@ std::string arpres_to_string(DWORD arp_res)
 
 #else // OMW_PLAT_WIN
 
-#if PRJ_DEBUG
-#include <curl-thread/curl.h>
-app::ScanResult impl_scan(const ip::Addr4& addr)
-{
-    // TODO
-
-    omw::clock::timepoint_t dur_us = omw::clock::now();
-
-    mac::Addr mac;
-    static size_t cnt = 0;
-    if (cnt == 0) { mac = mac::EUI48(0x1c740d030201); }
-    else if (cnt == 1) { mac = mac::EUI48(0xb827eb030201); }
-    else if (cnt == 2) { mac = mac::EUI48(0x00136A030201); }
-    else if (cnt == 3) { mac = mac::EUI48(0xB8D812600201); }
-    // else if (cnt == ) { mac = mac::EUI48(0x030201); }
-    ++cnt;
-
-#if 1
-    int delay_ms = curl::random(2, 400);
-    // if (addr == ip::Addr4(192, 168, 1, 123)) { delay_ms = 3000; }
-    const auto t = omw::clock::now();
-    while (!omw::clock::elapsed_ms(omw::clock::now(), t, delay_ms)) {}
-#endif
+#include "application/arp-sweep.h"
+#include "application/targets.h"
 
-    dur_us = omw::clock::now() - dur_us;
-
-    return app::ScanResult(addr, mac, (uint32_t)((dur_us + 500) / 1000), app::lookupVendor(mac));
-}
-#else  // PRJ_DEBUG
 app::ScanResult impl_scan(const ip::Addr4& addr)
 {
-    // TODO
-}
-#endif // PRJ_DEBUG
+    app::ScanResult r;
 
+    app::TargetRange range(addr, 1, ip::SubnetMask4(0)); // a /0 block skips 0.0.0.0 and 255.255.255.255 only
+    (void)app::arpSweep(range, [&r](const app::ScanResult& res) { r = res; }, app::Options());
 
+    return r;
+}
 
 #endif // OMW_PLAT_WIN
@@ -0,0 +1,558 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "middleware/addr-set.h"
+#include "middleware/cli.h"
+#include "middleware/interrupt.h"
+#include "middleware/ip-addr.h"
+#include "targets.h"
+
+
+
+static uint64_t mix(uint64_t value);
+static bool parseNumber(const char*& p, const char* end, size_t maxDigits, uint32_t& value);
+static size_t parseOctets(const char*& p, const char* end, uint8_t* octets);
+static bool parseEntry(const char* p, const char* end, app::TargetRange& range);
+
+
+
+app::TargetRange::TargetRange()
+    : m_mask(), m_base(0), m_blockSize(1), m_hostsPerBlock(0), m_firstHost(0), m_size(0), m_next(0)
+{}
+
+app::TargetRange::TargetRange(const ip::Addr4& first, uint64_t count, const ip::SubnetMask4& mask)
+    : m_mask(mask), m_base(0), m_blockSize(1), m_hostsPerBlock(0), m_firstHost(0), m_size(0), m_next(0)
+{
+    const uint64_t hostMask = mask.hostMask().value();
+
+    m_base = first.value() & ~hostMask;
+    m_blockSize = hostMask + 1;
+
+    // /31 and /32 blocks consist of the network and broadcast address only
+    m_hostsPerBlock = (m_blockSize > 2 ? m_blockSize - 2 : 0);
+
+    if (m_hostsPerBlock > 0)
+    {
+        // number of usable addresses in [m_base, addr)
+        const auto hostsBelow = [this](uint64_t addr) {
+            const uint64_t offset = addr - m_base;
+            const uint64_t host = offset % m_blockSize;
+            return ((offset / m_blockSize) * m_hostsPerBlock + (host > 0 ? host - 1 : 0));
+        };
+
+        const uint64_t end = std::min<uint64_t>((uint64_t)first.value() + count, (uint64_t)1 << ip::Addr4::bit_count);
+
+        m_firstHost = hostsBelow(first.value());
+        m_size = (size_t)(hostsBelow(end) - m_firstHost);
+    }
+}
+
+bool app::TargetRange::next(ip::Addr4& addr)
+{
+    if (m_next >= m_size) { return false; }
+
+    addr = this->at(m_next);
+    ++m_next;
+
+    return true;
+}
+
+void app::TargetRange::addTo(ip::AddrSet4& set) const
+{
+    if (m_size == 0) { return; }
+
+    const uint64_t lastHost = m_firstHost + m_size - 1;
+    const uint64_t firstBlock = m_firstHost / m_hostsPerBlock;
+    const uint64_t lastBlock = lastHost / m_hostsPerBlock;
+
+    for (uint64_t blk = firstBlock; blk <= lastBlock; ++blk)
+    {
+        const uint64_t first = std::max(blk * m_hostsPerBlock, m_firstHost);
+        const uint64_t last = std::min((blk + 1) * m_hostsPerBlock - 1, lastHost);
+
+        set.add(this->at((size_t)(first - m_firstHost)), this->at((size_t)(last - m_firstHost)));
+    }
+}
+
+ip::Addr4 app::TargetRange::at(size_t idx) const
+{
+    const uint64_t host = m_firstHost + idx;
+    const uint64_t addr = m_base + (host / m_hostsPerBlock) * m_blockSize + (host % m_hostsPerBlock) + 1;
+
+    return ip::Addr4((ip::Addr4::value_type)addr);
+}
+
+
+
+app::TargetSet::TargetSet()
+    : m_set(), m_offsets(), m_size(0), m_interval(0), m_next(0)
+{}
+
+app::TargetSet::TargetSet(const ip::AddrSet4& set)
+    : m_set(set), m_offsets(), m_size(0), m_interval(0), m_next(0)
+{
+    const auto& intervals = m_set.intervals();
+
+    m_offsets.reserve(intervals.size());
+
+    for (const auto& iv : intervals)
+    {
+        m_offsets.push_back(m_size);
+        m_size += (size_t)((uint64_t)iv.last - iv.first + 1);
+    }
+
+    if (!intervals.empty()) { m_next = intervals[0].first; }
+}
+
+bool app::TargetSet::next(ip::Addr4& addr)
+{
+    const auto& intervals = m_set.intervals();
+
+    if (m_interval >= intervals.size()) { return false; }
+
+    addr = ip::Addr4((ip::Addr4::value_type)m_next);
+
+    if (m_next < intervals[m_interval].last) { ++m_next; }
+    else if (++m_interval < intervals.size()) { m_next = intervals[m_interval].first; }
+
+    return true;
+}
+
+ip::Addr4 app::TargetSet::at(size_t idx) const
+{
+    const size_t i = (size_t)(std::upper_bound(m_offsets.begin(), m_offsets.end(), idx) - m_offsets.begin()) - 1;
+    return ip::Addr4((ip::Addr4::value_type)(m_set.intervals()[i].first + (idx - m_offsets[i])));
+}
+
+
+
+app::TargetPermutation::TargetPermutation(const TargetSet& targets, uint64_t seed)
+    : m_targets(targets), m_keys(), m_halfBits(0), m_halfMask(0), m_next(0)
+{
+    for (size_t i = 0; i < rounds; ++i) { m_keys[i] = mix(seed + i); }
+
+    // the domain has 2 * m_halfBits bits and is at most 4 times the size, so the cycle walk is short
+    while (((uint64_t)1 << (2 * m_halfBits)) < (uint64_t)m_targets.size()) { ++m_halfBits; }
+    m_halfMask = ((uint64_t)1 << m_halfBits) - 1;
+}
+
+bool app::TargetPermutation::next(ip::Addr4& addr)
+{
+    if (m_next >= m_targets.size()) { return false; }
+
+    addr = this->at(m_next);
+    ++m_next;
+
+    return true;
+}
+
+uint64_t app::TargetPermutation::permute(uint64_t idx) const
+{
+    uint64_t value = idx;
+
+    // the network is a bijection on the domain, so walking its cycle from an index in range leads back into the range
+    do
+    {
+        uint64_t left = value >> m_halfBits;
+        uint64_t right = value & m_halfMask;
+
+        for (size_t i = 0; i < rounds; ++i)
+        {
+            const uint64_t tmp = left ^ (mix(right ^ m_keys[i]) & m_halfMask);
+            left = right;
+            right = tmp;
+        }
+
+        value = (left << m_halfBits) | right;
+    }
+    while (value >= (uint64_t)m_targets.size());
+
+    return value;
+}
+
+
+
+app::TargetChain::TargetChain(TargetGenerator& first, TargetGenerator& second)
+    : m_first(first), m_second(second)
+{}
+
+bool app::TargetChain::next(ip::Addr4& addr) { return (m_first.next(addr) || m_second.next(addr)); }
+
+size_t app::TargetChain::size() const
+{
+    const size_t a = m_first.size();
+    const size_t b = m_second.size();
+
+    return (((a == unknown_size) || (b == unknown_size)) ? unknown_size : (a + b));
+}
+
+
+
+app::TargetShard::TargetShard(TargetGenerator& targets, size_t index, size_t count)
+    : m_targets(targets), m_index(index), m_count(count), m_skip(index)
+{}
+
+bool app::TargetShard::next(ip::Addr4& addr)
+{
+    for (; m_skip > 0; --m_skip)
+    {
+        if (!m_targets.next(addr)) { return false; }
+    }
+
+    if (!m_targets.next(addr)) { return false; }
+    m_skip = m_count - 1;
+
+    return true;
+}
+
+size_t app::TargetShard::size() const
+{
+    const size_t n = m_targets.size();
+
+    if (n == unknown_size) { return unknown_size; }
+    return (n > m_index ? (n - m_index - 1) / m_count + 1 : 0);
+}
+
+
+
+app::TargetCursor::TargetCursor(TargetGenerator& targets)
+    : m_targets(targets), m_position(0), m_interrupted(false)
+{}
+
+bool app::TargetCursor::next(ip::Addr4& addr)
+{
+    if (interrupt::requested())
+    {
+        m_interrupted = true;
+        return false;
+    }
+
+    if (!m_targets.next(addr)) { return false; }
+    ++m_position;
+
+    return true;
+}
+
+bool app::TargetCursor::skip(uint64_t count)
+{
+    ip::Addr4 addr;
+
+    for (; count > 0; --count)
+    {
+        while (!m_targets.next(addr))
+        {
+            if (!m_targets.stalled()) { return false; }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        ++m_position;
+    }
+
+    return true;
+}
+
+
+
+/**
+ * @brief Reads the entries of a target stream on a thread of its own.
+ */
+class app::TargetStream::Reader
+{
+public:
+    Reader(const std::shared_ptr<std::istream>& is, const std::string& name)
+        : m_is(is), m_name(name), m_line(), m_lineNumber(0), entryCount(0), errorCount(0), mtx(), cv(), queue(), ended(false), stop(false)
+    {}
+
+    virtual ~Reader() {}
+
+    Reader(const Reader& other) = delete;
+    Reader& operator=(const Reader& other) = delete;
+
+    void run();
+
+private:
+    std::shared_ptr<std::istream> m_is;
+    std::string m_name;
+    char m_line[max_line_length + 1];
+    size_t m_lineNumber;
+
+    bool readEntry(app::TargetRange& range);
+
+public:
+    std::atomic<size_t> entryCount;
+    std::atomic<size_t> errorCount;
+
+    std::mutex mtx;
+    std::condition_variable cv; // notified on every change of `queue`, `ended` and `stop`
+    std::deque<app::TargetRange> queue;
+    bool ended; // the reader has returned
+    bool stop;  // the stream is destroyed, the reader has to return
+};
+
+void app::TargetStream::Reader::run()
+{
+    app::TargetRange range;
+
+    while (this->readEntry(range))
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        cv.wait(lock, [&]() { return ((queue.size() < queue_capacity) || stop); });
+        if (stop) { break; }
+
+        queue.push_back(range);
+        lock.unlock();
+        cv.notify_all();
+    }
+
+    {
+        std::lock_guard<std::mutex> lg(mtx);
+        ended = true;
+    }
+
+    cv.notify_all();
+}
+
+/**
+ * Reads lines until one contains an entry, which is set to `range`. Returns `false` at the end of the stream.
+ */
+bool app::TargetStream::Reader::readEntry(app::TargetRange& range)
+{
+    while (true)
+    {
+        m_is->getline(m_line, sizeof(m_line));
+
+        // `getline()` fails at the end of the stream, or if the line doesn't fit into the buffer
+        bool truncated = false;
+        if (m_is->fail())
+        {
+            if (m_is->bad() || m_is->eof()) { return false; }
+
+            truncated = true;
+            m_is->clear();
+            m_is->ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        }
+
+        ++m_lineNumber;
+
+        const char* p = m_line;
+        const char* end = m_line + std::strlen(m_line);
+
+        const char* const comment = (const char*)std::memchr(p, '#', (size_t)(end - p));
+        if (comment) { end = comment; }
+
+        while ((p < end) && ((*p == ' ') || (*p == '\t'))) { ++p; }
+        while ((p < end) && ((*(end - 1) == ' ') || (*(end - 1) == '\t') || (*(end - 1) == '\r'))) { --end; }
+
+        // the entry itself may be cut off if there is no comment
+        if (truncated && !comment)
+        {
+            cli::printError(m_name + ":" + std::to_string(m_lineNumber) + ": line too long");
+            ++errorCount;
+        }
+        else if (p != end)
+        {
+            if (parseEntry(p, end, range))
+            {
+                ++entryCount;
+                return true;
+            }
+
+            cli::printError(m_name + ":" + std::to_string(m_lineNumber) + ": invalid entry \"" + std::string(p, end) + "\"");
+            ++errorCount;
+        }
+    }
+}
+
+app::TargetStream::TargetStream(const std::shared_ptr<std::istream>& is, const std::string& name, const ip::AddrSet4& excluded)
+    : m_reader(std::make_shared<Reader>(is, name)), m_excluded(excluded), m_range(), m_stalled(false), m_excludedCount(0)
+{
+    // A reader which is blocked in the stream can't be interrupted portably, so it's not joined. The thread keeps the
+    // reader and with it the stream alive until it returns.
+    std::shared_ptr<Reader> reader = m_reader;
+    std::thread([reader]() { reader->run(); }).detach();
+}
+
+app::TargetStream::~TargetStream()
+{
+    {
+        std::lock_guard<std::mutex> lg(m_reader->mtx);
+        m_reader->stop = true;
+    }
+
+    m_reader->cv.notify_all();
+}
+
+bool app::TargetStream::next(ip::Addr4& addr)
+{
+    while (true)
+    {
+        while (m_range.next(addr))
+        {
+            if (!m_excluded.contains(addr)) { return true; }
+            ++m_excludedCount;
+        }
+
+        {
+            std::lock_guard<std::mutex> lg(m_reader->mtx);
+
+            if (m_reader->queue.empty())
+            {
+                m_stalled = !m_reader->ended;
+                return false;
+            }
+
+            m_range = m_reader->queue.front();
+            m_reader->queue.pop_front();
+        }
+
+        m_reader->cv.notify_all(); // there is room for the reader
+    }
+}
+
+size_t app::TargetStream::entryCount() const { return m_reader->entryCount.load(); }
+size_t app::TargetStream::errorCount() const { return m_reader->errorCount.load(); }
+
+
+
+/**
+ * SplitMix64 finalizer, a fast bijective mix of all bits.
+ */
+uint64_t mix(uint64_t value)
+{
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+    return (value ^ (value >> 31));
+}
+
+/**
+ * Parses a decimal number of 1 to `maxDigits` digits and advances `p` past it.
+ */
+bool parseNumber(const char*& p, const char* end, size_t maxDigits, uint32_t& value)
+{
+    const char* const begin = p;
+    value = 0;
+
+    while ((p < end) && (*p >= '0') && (*p <= '9') && ((size_t)(p - begin) < maxDigits))
+    {
+        value = value * 10 + (uint32_t)(*p - '0');
+        ++p;
+    }
+
+    return ((p != begin) && ((p == end) || (*p < '0') || (*p > '9')));
+}
+
+/**
+ * Parses up to 4 dot separated octets and advances `p` past them. Returns the number of octets, 0 on a syntax error.
+ */
+size_t parseOctets(const char*& p, const char* end, uint8_t* octets)
+{
+    size_t n = 0;
+
+    while (n < ip::Addr4::octet_count)
+    {
+        uint32_t value;
+        if (!parseNumber(p, end, 3, value) || (value > UINT8_MAX)) { return 0; }
+
+        octets[n++] = (uint8_t)value;
+
+        if ((p < end) && (*p == '.')) { ++p; }
+        else { return n; }
+    }
+
+    return 0; // a fifth octet
+}
+
+/**
+ * Same semantics as `parseRange()` in process.cpp, but it works in place on the characters of a line and doesn't throw.
+ */
+bool parseEntry(const char* p, const char* end, app::TargetRange& range)
+{
+    uint8_t octets[ip::Addr4::octet_count];
+
+    if (parseOctets(p, end, octets) != ip::Addr4::octet_count) { return false; }
+    const ip::Addr4 start(octets[0], octets[1], octets[2], octets[3]);
+
+    uint8_t endOctets[ip::Addr4::octet_count];
+    size_t endCount = 0;
+    if ((p < end) && (*p == '-'))
+    {
+        ++p;
+        endCount = parseOctets(p, end, endOctets);
+        if (endCount == 0) { return false; }
+    }
+
+    int prefixSize = -1;
+    if ((p < end) && (*p == '/'))
+    {
+        ++p;
+        uint32_t value;
+        if (!parseNumber(p, end, 2, value) || (value > ip::Addr4::bit_count)) { return false; }
+
+        // a /32 is treated like no mask, as by `parseRange()`
+        if (value < ip::Addr4::bit_count) { prefixSize = (int)value; }
+    }
+
+    if (p != end) { return false; }
+
+    ip::SubnetMask4 mask(prefixSize < 0 ? 0 : prefixSize); // assumed below if there is none
+    uint64_t count;
+
+    if (endCount > 0)
+    {
+        if (prefixSize < 0)
+        {
+            if ((start & ip::SubnetMask4(16)) == ip::Addr4(192, 168, 0, 0)) { mask = ip::SubnetMask4(24); }
+            else { mask = ip::SubnetMask4((int)(ip::Addr4::bit_count - 8 * endCount)); }
+        }
+
+        // the missing high octets are the ones of the start address
+        ip::Addr4::value_type last = start.value();
+        for (size_t i = 0; i < endCount; ++i)
+        {
+            const size_t shift = 8 * (endCount - 1 - i);
+            last = (last & ~((ip::Addr4::value_type)UINT8_MAX << shift)) | ((ip::Addr4::value_type)endOctets[i] << shift);
+        }
+
+        if (last < start.value()) { return false; }
+        count = (uint64_t)last - start.value() + 1;
+    }
+    else if (prefixSize < 0)
+    {
+        // x.x.x.0 is assumed to be a /24, anything else a single address
+        if (start.octetLow() == 0)
+        {
+            mask = ip::SubnetMask4(24);
+            count = 256;
+        }
+        else
+        {
+            mask = ip::SubnetMask4(8);
+            count = 1;
+        }
+    }
+    else if (start.octetLow() == 0) { count = (uint64_t)mask.hostMask().value() + 1; }
+    else { count = (uint64_t)(start | ~mask).value() - start.value() + 1; }
+
+    range = app::TargetRange(start, count, mask);
+
+    return true;
+}
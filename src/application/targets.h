@@ -0,0 +1,331 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_APPLICATION_TARGETS_H
+#define IG_APPLICATION_TARGETS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "middleware/addr-set.h"
+#include "middleware/ip-addr.h"
+
+
+namespace app {
+
+/**
+ * @brief Produces the addresses to scan one at a time, so that the targets never have to be held in memory.
+ */
+class TargetGenerator
+{
+public:
+    TargetGenerator() {}
+    virtual ~TargetGenerator() {}
+
+    /**
+     * Sets `addr` to the next target. Returns `false` if all targets have been generated.
+     */
+    virtual bool next(ip::Addr4& addr) = 0;
+
+    /**
+     * Only meaningful after `next()` has returned `false`. Returns `true` if no target is available yet but more will
+     * follow, e.g. while a stream is being read, and `next()` has to be called again later. The sweeps never wait for
+     * targets, they keep receiving in the meantime.
+     */
+    virtual bool stalled() const { return false; }
+
+    /**
+     * Called by the sweeps when `addr` won't get any more results, because it has answered, has timed out or has been
+     * skipped. The results of the target have been passed to the result handler before. May be called by a different
+     * thread than `next()`, the generators which don't need it ignore it.
+     */
+    virtual void finished(const ip::Addr4& addr) { (void)addr; }
+
+    /**
+     * Total number of targets, for progress reporting. `unknown_size` if the targets are not known in advance, it's
+     * greater than any real count so that it can be used as a limit.
+     */
+    virtual size_t size() const = 0;
+
+public:
+    static constexpr size_t unknown_size = SIZE_MAX;
+};
+
+/**
+ * @brief Consecutive addresses, without the network and broadcast addresses.
+ *
+ * Only the first address, the count and the mask are stored. The addresses whose host part is all 0 or all 1 are
+ * skipped arithmetically, so the memory usage is the same for a single address and a /8, and any address can be
+ * computed from its index in constant time.
+ */
+class TargetRange : public TargetGenerator
+{
+public:
+    TargetRange();
+
+    /**
+     * `count` addresses starting at `first`. The network and broadcast addresses of every `mask` sized block are skipped.
+     */
+    TargetRange(const ip::Addr4& first, uint64_t count, const ip::SubnetMask4& mask);
+
+    virtual ~TargetRange() {}
+
+    virtual bool next(ip::Addr4& addr);
+    virtual size_t size() const { return m_size; }
+
+    bool empty() const { return (m_size == 0); }
+    const ip::SubnetMask4& mask() const { return m_mask; }
+
+    /**
+     * Returns the address at `idx`, which has to be less than `size()`.
+     */
+    ip::Addr4 at(size_t idx) const;
+
+    ip::Addr4 front() const { return this->at(0); }
+    ip::Addr4 back() const { return this->at(m_size - 1); }
+
+    /**
+     * Restarts the generator at the first address.
+     */
+    void rewind() { m_next = 0; }
+
+    /**
+     * Adds the addresses of the range to `set`, one interval per block.
+     */
+    void addTo(ip::AddrSet4& set) const;
+
+private:
+    ip::SubnetMask4 m_mask;
+    uint64_t m_base;          // network address of the block which contains the first address
+    uint64_t m_blockSize;     // number of addresses per block
+    uint64_t m_hostsPerBlock; // number of usable addresses per block
+    uint64_t m_firstHost;     // number of usable addresses from `m_base` to the first address
+    size_t m_size;
+    size_t m_next;
+};
+
+/**
+ * @brief The addresses of a normalized `ip::AddrSet4`, in ascending order.
+ *
+ * Overlapping ranges are generated once and exclusions cost nothing while generating, they have been subtracted from
+ * the set beforehand.
+ */
+class TargetSet : public TargetGenerator
+{
+public:
+    TargetSet();
+    explicit TargetSet(const ip::AddrSet4& set);
+    virtual ~TargetSet() {}
+
+    virtual bool next(ip::Addr4& addr);
+    virtual size_t size() const { return m_size; }
+
+    bool empty() const { return (m_size == 0); }
+    const ip::AddrSet4& set() const { return m_set; }
+
+    /**
+     * Returns the address at `idx`, which has to be less than `size()`. Logarithmic in the number of intervals.
+     */
+    ip::Addr4 at(size_t idx) const;
+
+private:
+    ip::AddrSet4 m_set;
+    std::vector<size_t> m_offsets; // index of the first address of each interval
+    size_t m_size;
+    size_t m_interval; // interval which is being generated
+    uint64_t m_next;   // next address of that interval
+};
+
+/**
+ * @brief The addresses of a `TargetSet` in a pseudo random order, so that a sweep doesn't probe one subnet after the
+ * other.
+ *
+ * The indices are permuted by a Feistel network over the next even power of 2, the results which are out of range are
+ * fed through again (cycle walking) until one is in range. The permutation is computed per index from the keys, only
+ * the position is state, and the same seed always gives the same order.
+ */
+class TargetPermutation : public TargetGenerator
+{
+public:
+    static constexpr size_t rounds = 4;
+
+public:
+    /**
+     * @param targets The reference has to be valid as long as the permutation is used
+     * @param seed Key of the order
+     */
+    TargetPermutation(const TargetSet& targets, uint64_t seed);
+
+    virtual ~TargetPermutation() {}
+
+    TargetPermutation(const TargetPermutation& other) = delete;
+    TargetPermutation& operator=(const TargetPermutation& other) = delete;
+
+    virtual bool next(ip::Addr4& addr);
+    virtual size_t size() const { return m_targets.size(); }
+
+    /**
+     * Returns the address at `idx` of the permuted order, which has to be less than `size()`.
+     */
+    ip::Addr4 at(size_t idx) const { return m_targets.at((size_t)this->permute(idx)); }
+
+private:
+    const TargetSet& m_targets;
+    uint64_t m_keys[rounds];
+    size_t m_halfBits;
+    uint64_t m_halfMask;
+    size_t m_next;
+
+    uint64_t permute(uint64_t idx) const;
+};
+
+/**
+ * @brief The targets of `first`, followed by the ones of `second`.
+ */
+class TargetChain : public TargetGenerator
+{
+public:
+    TargetChain(TargetGenerator& first, TargetGenerator& second);
+    virtual ~TargetChain() {}
+
+    TargetChain(const TargetChain& other) = delete;
+    TargetChain& operator=(const TargetChain& other) = delete;
+
+    virtual bool next(ip::Addr4& addr);
+    virtual bool stalled() const { return (m_first.stalled() || m_second.stalled()); }
+    virtual size_t size() const;
+
+private:
+    TargetGenerator& m_first;
+    TargetGenerator& m_second;
+};
+
+/**
+ * @brief Every n-th target of a generator, so that n instances scan disjoint slices which together cover all targets.
+ *
+ * The slices interleave, so each one is spread over the whole target space. All instances have to generate the same
+ * targets in the same order, that is the same arguments, exclusions, target list and seed.
+ */
+class TargetShard : public TargetGenerator
+{
+public:
+    /**
+     * @param targets The reference has to be valid as long as the shard is used
+     * @param index 0 based, less than `count`
+     * @param count Number of shards
+     */
+    TargetShard(TargetGenerator& targets, size_t index, size_t count);
+
+    virtual ~TargetShard() {}
+
+    TargetShard(const TargetShard& other) = delete;
+    TargetShard& operator=(const TargetShard& other) = delete;
+
+    virtual bool next(ip::Addr4& addr);
+    virtual bool stalled() const { return m_targets.stalled(); }
+    virtual size_t size() const;
+
+private:
+    TargetGenerator& m_targets;
+    size_t m_index;
+    size_t m_count;
+    size_t m_skip; // targets of the other shards before the next one of this shard
+};
+
+/**
+ * @brief Passes the targets of a generator through and counts them, until the process is interrupted.
+ *
+ * After `SIGINT` or `SIGTERM` no more targets are generated, so the sweeps finish the probes which are in flight and
+ * return. Every target which has been passed on is probed, the count is the position to resume from.
+ */
+class TargetCursor : public TargetGenerator
+{
+public:
+    explicit TargetCursor(TargetGenerator& targets);
+    virtual ~TargetCursor() {}
+
+    TargetCursor(const TargetCursor& other) = delete;
+    TargetCursor& operator=(const TargetCursor& other) = delete;
+
+    virtual bool next(ip::Addr4& addr);
+    virtual bool stalled() const { return (!m_interrupted && m_targets.stalled()); }
+    virtual size_t size() const { return m_targets.size(); }
+
+    /**
+     * Discards the first `count` targets, to continue an interrupted sweep. Returns `false` if there are fewer. Waits for
+     * stalled targets.
+     */
+    bool skip(uint64_t count);
+
+    uint64_t position() const { return m_position; } ///< number of generated and skipped targets
+    bool interrupted() const { return m_interrupted; }
+
+private:
+    TargetGenerator& m_targets;
+    uint64_t m_position;
+    bool m_interrupted;
+};
+
+/**
+ * @brief Targets read line by line from a stream, while they are being scanned.
+ *
+ * One address, subnet or range per line, in the same format as the ADDR arguments. Everything after a `#` is a comment.
+ * Only the current line is held in memory and it's parsed in place, so the list can be of any length and may still be
+ * written while the scan is running. Invalid lines are reported and skipped.
+ *
+ * The stream is read by a thread of its own, which passes the parsed entries through a bounded queue. So a slow
+ * producer doesn't block the sweep, `next()` returns `false` and `stalled()` `true` while the queue is empty.
+ *
+ * The excluded addresses are checked per address, entries which overlap each other or the ADDR arguments are scanned
+ * multiple times.
+ */
+class TargetStream : public TargetGenerator
+{
+public:
+    static constexpr size_t max_line_length = 255;
+    static constexpr size_t queue_capacity = 256; ///< max number of read entries waiting to be scanned
+
+public:
+    /**
+     * @param is The source, e.g. an opened file or `std::cin`. It's owned by the reader, which may still be blocked in
+     * it when the target stream is destroyed, e.g. after an interruption. The reader returns with the next line or the
+     * end of the stream then.
+     * @param name Used in error messages
+     * @param excluded Normalized, the reference has to be valid as long as the stream is used
+     */
+    TargetStream(const std::shared_ptr<std::istream>& is, const std::string& name, const ip::AddrSet4& excluded);
+
+    virtual ~TargetStream();
+
+    TargetStream(const TargetStream& other) = delete;
+    TargetStream& operator=(const TargetStream& other) = delete;
+
+    virtual bool next(ip::Addr4& addr);
+    virtual bool stalled() const { return m_stalled; }
+    virtual size_t size() const { return unknown_size; }
+
+    size_t entryCount() const;                               ///< number of valid lines read so far
+    size_t errorCount() const;                               ///< number of invalid lines read so far
+    size_t excludedCount() const { return m_excludedCount; } ///< number of skipped addresses
+
+private:
+    class Reader; // shared with the reader thread, which may outlive the stream
+
+    std::shared_ptr<Reader> m_reader;
+    const ip::AddrSet4& m_excluded;
+    TargetRange m_range; // of the current entry
+    bool m_stalled;
+    size_t m_excludedCount;
+};
+
+} // namespace app
+
+
+#endif // IG_APPLICATION_TARGETS_H
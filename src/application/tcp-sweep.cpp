@@ -0,0 +1,506 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "application/options.h"
+#include "application/result.h"
+#include "middleware/cli.h"
+#include "middleware/ip-addr.h"
+#include "middleware/mac-addr.h"
+#include "middleware/pacer.h"
+#include "middleware/rtt-estimator.h"
+#include "tcp-sweep.h"
+
+#include <omw/cli.h>
+#include <omw/clock.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+
+using omw::clock::timepoint_t;
+using std::cout;
+using std::endl;
+
+
+
+namespace {
+
+constexpr timepoint_t initialTimeout_us = 1500000; // covers one SYN retransmission of the kernel
+constexpr timepoint_t minTimeout_us = 100000;
+constexpr timepoint_t maxTimeout_us = 3000000;
+constexpr size_t txBurst = 64;          // max number of connects between two `epoll_wait()` calls
+constexpr size_t reservedFds = 32;      // left for the rest of the process
+constexpr size_t maxConnections = 16384; // about half of the default ephemeral port range
+constexpr int eventCount = 256;
+constexpr int stallRetry_ms = 10; // wait timeout while the targets are stalled
+
+struct Connection
+{
+    ip::Addr4 ip;
+    uint16_t port;
+    timepoint_t sent;
+    uint64_t serial; // 0 if the slot is free
+};
+
+struct Transmission
+{
+    int fd;
+    uint64_t serial;
+    timepoint_t time;
+};
+
+enum class ConnectStatus
+{
+    pending,
+    alive,  ///< SYN-ACK or RST
+    failed, ///< unreachable
+    busy,   ///< out of file descriptors or local ports, try again later
+};
+
+/**
+ * @brief Non-blocking connects multiplexed by epoll.
+ */
+class Connector
+{
+public:
+    Connector()
+        : m_epfd(-1), m_timerFd(-1), m_connections(), m_timeline(), m_active(0), m_serial(0), m_rtt(initialTimeout_us, minTimeout_us, maxTimeout_us)
+    {}
+
+    virtual ~Connector();
+
+    Connector(const Connector& other) = delete;
+    Connector& operator=(const Connector& other) = delete;
+
+    int open();
+
+    /**
+     * Adds a `timerfd` to the epoll set, `wait()` returns when it expires.
+     */
+    int addTimer(int fd);
+
+    size_t active() const { return m_active; }
+    const RttEstimator& rtt() const { return m_rtt; }
+
+    /**
+     * Starts a connection. If the status is `alive`, the connection has completed immediately and the result is written
+     * to `rtt`.
+     */
+    ConnectStatus connect(const ip::Addr4& addr, uint16_t port, timepoint_t now);
+
+    using completion_handler = std::function<void(const ip::Addr4& addr, uint16_t port, timepoint_t rtt, bool alive)>;
+
+    /**
+     * Closes the connections which have timed out and calls `handler` for each of them, as not alive. Returns the
+     * number of them.
+     */
+    size_t expire(timepoint_t now, const completion_handler& handler);
+
+    /**
+     * Returns the time of the next timeout, `-1` if there is none.
+     */
+    timepoint_t nextDeadline();
+
+    /**
+     * Waits up to `timeout_ms` for connections to complete and calls `handler` for each of them. Returns the number of
+     * events, or -1 on error.
+     */
+    int wait(int timeout_ms, const completion_handler& handler);
+
+private:
+    int m_epfd;
+    int m_timerFd;
+    std::vector<Connection> m_connections; // indexed by fd
+    std::deque<Transmission> m_timeline;   // ordered by time, all connections have the same timeout
+    size_t m_active;
+    uint64_t m_serial;
+    RttEstimator m_rtt;
+
+    void release(int fd);
+};
+
+} // namespace
+
+
+
+static size_t connectionLimit();
+static void printStats(const Connector& connector, size_t connects, size_t alive, size_t timedOut, size_t limit);
+
+
+
+int app::tcpSweep(app::TargetGenerator& targets, const app::ResultHandler& handler, const app::Options& options)
+{
+    const std::vector<uint16_t>& ports = options.ports();
+    if (ports.empty()) { return 0; }
+
+    Connector connector;
+    if (connector.open()) { return -(__LINE__); }
+
+    Pacer pacer;
+    if (pacer.open(options.rate(), options.burst())) { return -(__LINE__); }
+    if (pacer.enabled() && connector.addTimer(pacer.fd())) { return -(__LINE__); }
+
+    const size_t limit = connectionLimit();
+
+    std::unordered_set<ip::Addr4::value_type> found;
+    std::unordered_map<ip::Addr4::value_type, size_t> connecting; // number of pending connects by host
+    ip::Addr4 target;
+    bool more = targets.next(target); // the target which is being connected to
+    bool stalled = (!more && targets.stalled()); // no target available yet, more will follow
+
+    const auto pull = [&]() {
+        more = targets.next(target);
+        stalled = (!more && targets.stalled());
+    };
+    size_t nextPort = 0;
+    size_t connectCount = 0;
+    size_t timedOutCount = 0;
+
+    const auto report = [&](const ip::Addr4& addr, uint16_t port, timepoint_t rtt_us) {
+        if (found.insert(addr.value()).second)
+        {
+            handler(app::ScanResult(addr, mac::Addr::null, (uint32_t)((rtt_us + 500) / 1000), app::Vendor(), false, port));
+        }
+    };
+
+    // a host is finished when the connects to all its ports have been started and have completed
+    const auto completed = [&](const ip::Addr4& addr, uint16_t port, timepoint_t rtt_us, bool alive) {
+        if (alive) { report(addr, port, rtt_us); }
+
+        const auto it = connecting.find(addr.value());
+        if ((it == connecting.end()) || (--(it->second) > 0)) { return; }
+
+        connecting.erase(it);
+
+        // the current target may have ports left
+        if (!(more && (nextPort > 0) && (target == addr))) { targets.finished(addr); }
+    };
+
+    while (more || stalled || (connector.active() > 0))
+    {
+        timepoint_t now = omw::clock::now();
+
+        if (stalled) { pull(); }
+
+        timedOutCount += connector.expire(now, completed);
+
+        bool txBlocked = false;
+
+        for (size_t i = 0; (i < txBurst) && more && (connector.active() < limit) && pacer.ready(now); ++i)
+        {
+            // the remaining ports of a host which has been found already are skipped
+            if (found.count(target.value()) == 0)
+            {
+                const ConnectStatus status = connector.connect(target, ports[nextPort], now);
+
+                if (status == ConnectStatus::busy)
+                {
+                    txBlocked = true;
+                    break;
+                }
+
+                pacer.consume();
+                ++connectCount;
+
+                if (status == ConnectStatus::alive) { report(target, ports[nextPort], 0); }
+                else if (status == ConnectStatus::pending) { ++connecting[target.value()]; }
+
+                ++nextPort;
+            }
+            else { nextPort = ports.size(); }
+
+            if (nextPort >= ports.size())
+            {
+                // otherwise it's finished when the last pending connect completes
+                if (connecting.count(target.value()) == 0) { targets.finished(target); }
+
+                nextPort = 0;
+                pull();
+            }
+        }
+
+        // compute the wait timeout
+        int timeout_ms = 100;
+        bool paced = false;
+
+        if (more && (connector.active() < limit))
+        {
+            if (txBlocked) { timeout_ms = 1; }
+            else if (pacer.ready(now)) { timeout_ms = 0; }
+            else { paced = true; }
+        }
+        else if (stalled) { timeout_ms = stallRetry_ms; }
+
+        const timepoint_t deadline = connector.nextDeadline();
+        if (deadline >= 0)
+        {
+            const timepoint_t dt = (deadline > now ? deadline - now : 0);
+            timeout_ms = std::min(timeout_ms, (int)((dt + 999) / 1000));
+        }
+
+        // the timer wakes the loop up when the next connect may be started
+        if (paced) { pacer.arm(now); }
+
+        const int n = connector.wait(timeout_ms, completed);
+        if (n < 0) { return -(__LINE__); }
+    }
+
+    if (options.stats()) { printStats(connector, connectCount, found.size(), timedOutCount, limit); }
+
+    return 0;
+}
+
+
+
+Connector::~Connector()
+{
+    for (size_t fd = 0; fd < m_connections.size(); ++fd)
+    {
+        if (m_connections[fd].serial != 0) { close((int)fd); }
+    }
+
+    // the timer is owned by the pacer
+
+    if (m_epfd >= 0) { close(m_epfd); }
+}
+
+int Connector::open()
+{
+    m_epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epfd < 0)
+    {
+        cli::printError("epoll_create1() failed", std::strerror(errno));
+        return -(__LINE__);
+    }
+
+    return 0;
+}
+
+int Connector::addTimer(int fd)
+{
+    struct epoll_event ev;
+    std::memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+
+    if (epoll_ctl(m_epfd, EPOLL_CTL_ADD, fd, &ev) != 0)
+    {
+        cli::printError("epoll_ctl() failed", std::strerror(errno));
+        return -(__LINE__);
+    }
+
+    m_timerFd = fd;
+
+    return 0;
+}
+
+ConnectStatus Connector::connect(const ip::Addr4& addr, uint16_t port, timepoint_t now)
+{
+    const int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        if ((errno == EMFILE) || (errno == ENFILE) || (errno == ENOBUFS) || (errno == ENOMEM)) { return ConnectStatus::busy; }
+
+        cli::printError("failed to open TCP socket", std::strerror(errno));
+        return ConnectStatus::failed;
+    }
+
+    // no FIN handshake and no TIME_WAIT state after the probe
+    struct linger lin;
+    lin.l_onoff = 1;
+    lin.l_linger = 0;
+    (void)setsockopt(fd, SOL_SOCKET, SO_LINGER, &lin, sizeof(lin));
+
+    struct sockaddr_in sin;
+    std::memset(&sin, 0, sizeof(sin));
+    sin.sin_family = AF_INET;
+    sin.sin_port = htons(port);
+    sin.sin_addr.s_addr = htonl(addr.value());
+
+    if (::connect(fd, (const struct sockaddr*)(&sin), sizeof(sin)) == 0)
+    {
+        close(fd);
+        return ConnectStatus::alive;
+    }
+
+    const int err = errno;
+
+    if (err != EINPROGRESS)
+    {
+        close(fd);
+
+        if (err == ECONNREFUSED) { return ConnectStatus::alive; }
+        if ((err == EAGAIN) || (err == EADDRNOTAVAIL) || (err == ENOBUFS)) { return ConnectStatus::busy; } // out of local ports
+
+        return ConnectStatus::failed;
+    }
+
+    struct epoll_event ev;
+    std::memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLOUT;
+    ev.data.fd = fd;
+
+    if (epoll_ctl(m_epfd, EPOLL_CTL_ADD, fd, &ev) != 0)
+    {
+        cli::printError("epoll_ctl() failed", std::strerror(errno));
+        close(fd);
+        return ConnectStatus::failed;
+    }
+
+    if ((size_t)fd >= m_connections.size()) { m_connections.resize((size_t)fd + 1, Connection{ ip::Addr4(), 0, 0, 0 }); }
+
+    ++m_serial;
+    m_connections[fd] = Connection{ addr, port, now, m_serial };
+    m_timeline.push_back(Transmission{ fd, m_serial, now });
+    ++m_active;
+
+    return ConnectStatus::pending;
+}
+
+size_t Connector::expire(timepoint_t now, const completion_handler& handler)
+{
+    size_t r = 0;
+    const timepoint_t timeout = m_rtt.rto();
+
+    while (!m_timeline.empty() && ((m_timeline.front().time + timeout) <= now))
+    {
+        const Transmission tx = m_timeline.front();
+        m_timeline.pop_front();
+
+        // the fd may have completed and been reused in the meantime
+        if (m_connections[tx.fd].serial == tx.serial)
+        {
+            const Connection con = m_connections[tx.fd];
+
+            this->release(tx.fd);
+            ++r;
+
+            handler(con.ip, con.port, now - con.sent, false);
+        }
+    }
+
+    return r;
+}
+
+timepoint_t Connector::nextDeadline()
+{
+    // drop the connections which have completed already
+    while (!m_timeline.empty() && (m_connections[m_timeline.front().fd].serial != m_timeline.front().serial)) { m_timeline.pop_front(); }
+
+    return (m_timeline.empty() ? -1 : m_timeline.front().time + m_rtt.rto());
+}
+
+int Connector::wait(int timeout_ms, const completion_handler& handler)
+{
+    struct epoll_event events[eventCount];
+
+    const int n = epoll_wait(m_epfd, events, eventCount, timeout_ms);
+    if (n < 0)
+    {
+        if (errno == EINTR) { return 0; }
+
+        cli::printError("epoll_wait() failed", std::strerror(errno));
+        return -1;
+    }
+
+    const timepoint_t now = omw::clock::now();
+
+    for (int i = 0; i < n; ++i)
+    {
+        const int fd = events[i].data.fd;
+
+        if (fd == m_timerFd)
+        {
+            uint64_t expirations;
+            (void)read(fd, &expirations, sizeof(expirations));
+            continue;
+        }
+
+        const Connection con = m_connections[fd];
+
+        int err = 0;
+        socklen_t len = sizeof(err);
+        if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0) { err = errno; }
+
+        // SYN-ACK or RST
+        const bool alive = ((err == 0) || (err == ECONNREFUSED));
+        const timepoint_t rtt = (now > con.sent ? now - con.sent : 0);
+
+        if (alive) { m_rtt.addSample(rtt); }
+
+        this->release(fd);
+
+        handler(con.ip, con.port, rtt, alive);
+    }
+
+    return n;
+}
+
+void Connector::release(int fd)
+{
+    (void)epoll_ctl(m_epfd, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+
+    m_connections[fd].serial = 0;
+    --m_active;
+}
+
+/**
+ * Raises the soft file descriptor limit to the hard limit, and returns the number of connections which can be open at
+ * the same time.
+ */
+size_t connectionLimit()
+{
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) != 0) { return 256; }
+
+    if (rl.rlim_cur < rl.rlim_max)
+    {
+        const rlim_t cur = rl.rlim_cur;
+        rl.rlim_cur = rl.rlim_max;
+        if (setrlimit(RLIMIT_NOFILE, &rl) != 0) { rl.rlim_cur = cur; }
+    }
+
+    const size_t fds = (rl.rlim_cur == RLIM_INFINITY ? maxConnections : (size_t)rl.rlim_cur);
+    if (fds <= (reservedFds * 2)) { return reservedFds; }
+
+    return std::min(fds - reservedFds, maxConnections);
+}
+
+void printStats(const Connector& connector, size_t connects, size_t alive, size_t timedOut, size_t limit)
+{
+    const RttEstimator& rtt = connector.rtt();
+
+    const auto toMs = [](timepoint_t t_us) {
+        std::ostringstream ss;
+        ss << std::fixed << std::setprecision(2) << ((double)t_us / 1000.0);
+        return ss.str();
+    };
+
+    cout << omw::fgBrightBlack;
+    cout << "connects: " << connects << ", alive hosts: " << alive << ", timed out: " << timedOut << ", concurrent connects: " << limit << endl;
+    if (rtt.sampleCount() > 0) { cout << "srtt " << toMs(rtt.srtt()) << "ms, rttvar " << toMs(rtt.rttvar()) << "ms, "; }
+    cout << "timeout " << toMs(rtt.rto()) << "ms, " << rtt.sampleCount() << " samples";
+    cout << omw::fgDefault << endl;
+}
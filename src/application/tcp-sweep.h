@@ -0,0 +1,34 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_APPLICATION_TCPSWEEP_H
+#define IG_APPLICATION_TCPSWEEP_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "application/options.h"
+#include "application/result.h"
+#include "application/targets.h"
+#include "middleware/ip-addr.h"
+
+
+namespace app {
+
+/**
+ * Scans the addresses generated by `targets` by non-blocking TCP `connect()` calls to the ports of `options.ports()`,
+ * which finds hosts that filter ICMP and ARP. A host is alive if a port answers with SYN-ACK or RST, `handler` is
+ * called once per alive host with the first port that answered. The results have no MAC address.
+ *
+ * The connections are multiplexed by epoll, the number of concurrent sockets is bounded by the file descriptor limit.
+ * Blocks until every connection has completed or timed out, returns 0 on success.
+ */
+int tcpSweep(app::TargetGenerator& targets, const app::ResultHandler& handler, const app::Options& options);
+
+} // namespace app
+
+
+#endif // IG_APPLICATION_TCPSWEEP_H
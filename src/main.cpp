@@ -4,18 +4,24 @@ date            24.03.2025
 copyright       GPL-3.0 - Copyright (c) 2025 Oliver Blaser
 */
 
+#include <algorithm>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <random>
 #include <string>
 #include <thread>
 #include <vector>
 
+#include "application/options.h"
 #include "application/process.h"
 #include "application/vendor-cache.h"
+#include "middleware/interrupt.h"
 #include "project.h"
 
 #include <curl-thread/curl.h>
 #include <omw/cli.h>
+#include <omw/string.h>
 #include <omw/windows/windows.h>
 
 
@@ -29,6 +35,25 @@ namespace argstr {
 const char* const noColor = "--no-colour";
 const char* const help = "--help";
 const char* const version = "--version";
+const char* const ring = "--ring";
+const char* const batch = "--batch";
+const char* const fanout = "--fanout";
+const char* const uring = "--uring";
+const char* const stats = "--stats";
+const char* const noNeigh = "--no-neigh";
+const char* const mode = "--mode";
+const char* const rate = "--rate";
+const char* const burst = "--burst";
+const char* const ports = "--ports";
+const char* const jobs = "--jobs";
+const char* const excludeFile = "--exclude-file";
+const char* const inputList = "-iL";
+const char* const stdinList = "-";
+const char* const randomize = "--randomize";
+const char* const sorted = "--sorted";
+const char* const shard = "--shard";
+const char* const checkpoint = "--checkpoint";
+const char* const resume = "--resume";
 
 bool contains(const std::vector<std::string>& rawArgs, const char* arg)
 {
@@ -48,7 +73,43 @@ bool contains(const std::vector<std::string>& rawArgs, const char* arg)
 
 bool isOption(const std::string& arg) { return (!arg.empty()) && (arg[0] == '-'); }
 
-bool isKnownOption(const std::string& arg) { return ((arg == noColor) || (arg == help) || (arg == version)); }
+/**
+ * Returns `true` if `arg` has the format `NAME=VALUE`.
+ */
+bool isValueOption(const std::string& arg, const char* name)
+{
+    const size_t len = std::strlen(name);
+    return ((arg.size() > (len + 1)) && (arg.compare(0, len, name) == 0) && (arg[len] == '='));
+}
+
+/**
+ * Returns the value of the last `NAME=VALUE` argument, or an empty string if there is none.
+ */
+std::string value(const std::vector<std::string>& rawArgs, const char* name)
+{
+    std::string r;
+
+    for (size_t i = 0; i < rawArgs.size(); ++i)
+    {
+        if (isValueOption(rawArgs[i], name)) { r = rawArgs[i].substr(std::strlen(name) + 1); }
+    }
+
+    return r;
+}
+
+bool isKnownOption(const std::string& arg)
+{
+    return ((arg == noColor) || (arg == help) || (arg == version) || (arg == ring) || isValueOption(arg, batch) || isValueOption(arg, fanout) || (arg == uring) || (arg == stats) ||
+            (arg == noNeigh) || isValueOption(arg, mode) || isValueOption(arg, rate) || isValueOption(arg, burst) ||
+            isValueOption(arg, ports) || isValueOption(arg, jobs) ||
+            isValueOption(arg, excludeFile) || (arg == inputList) || (arg == stdinList) ||
+            (arg == randomize) || isValueOption(arg, randomize) || (arg == sorted) || isValueOption(arg, shard) || isValueOption(arg, checkpoint) || (arg == resume));
+}
+
+/**
+ * Returns `true` if the argument at `idx` is the file name of a preceding `-iL`.
+ */
+bool isInputListValue(const std::vector<std::string>& rawArgs, size_t idx) { return ((idx > 0) && (rawArgs[idx - 1] == inputList)); }
 
 bool check(const std::vector<std::string>& args);
 
@@ -89,11 +150,42 @@ void printHelp()
     cout << "  IPv4 address range to scan, specified by subnet mask or range:" << endl;
     cout << "   - 192.168.1.0 = 192.168.1.0/24" << endl;
     cout << "   - 192.168.1.200-254/26 or 192.168.3.0-4.255 etc." << endl;
+    cout << "  IPv6 prefix, the hosts are discovered by multicast on the local links:" << endl;
+    cout << "   - fd00:: = fd00::/64" << endl;
+    cout << "   - fe80::/10 (link-local addresses) or ::/0 (all) etc." << endl;
+    cout << "  Exclusion, IPv4 address range with a leading '!' (quote it in the shell):" << endl;
+    cout << "   - 192.168.0.0/16 '!192.168.5.0/24' '!192.168.1.1'" << endl;
+    cout << "  " << argstr::stdinList << " reads the IPv4 ADDRs from stdin, one per line, while scanning" << endl;
     cout << endl;
     cout << "Options:" << endl;
     cout << std::left << setw(lw) << std::string("  ") + argstr::noColor << "monochrome console output" << endl;
     cout << std::left << setw(lw) << std::string("  ") + argstr::help << "prints this help text" << endl;
     cout << std::left << setw(lw) << std::string("  ") + argstr::version << "prints version info" << endl;
+    cout << std::left << setw(lw) << std::string("  ") + argstr::stats << "print scan statistics" << endl;
+    cout << std::left << setw(lw) << std::string("  ") + argstr::excludeFile + "=F" << "don't scan the addresses listed in file F, one ADDR per line" << endl;
+    cout << std::left << setw(lw) << std::string("  ") + argstr::inputList + " F" << "scan the IPv4 addresses listed in file F, read while scanning" << endl;
+    cout << std::left << setw(lw) << std::string("  ") + argstr::randomize + "[=S]" << "scan the ADDR ranges in a pseudo random order, seed S repeats an order" << endl;
+    cout << std::left << setw(lw) << std::string("  ") + argstr::sorted << "print the results in the order of the targets, while scanning" << endl;
+    cout << std::left << setw(lw) << std::string("  ") + argstr::shard + "=I/N" << "scan only the I-th of N disjoint slices of the targets, for I = 1..N" << endl;
+    cout << std::left << setw(lw) << std::string("  ") + argstr::checkpoint + "=F" << "write the checkpoint to file F if interrupted (default " << app::Options::default_checkpoint_file << ")" << endl;
+    cout << std::left << setw(lw) << std::string("  ") + argstr::resume << "continue the interrupted sweep of the checkpoint, requires the same arguments" << endl;
+#ifndef OMW_PLAT_WIN
+    cout << std::left << setw(lw) << std::string("  ") + argstr::mode + "=M" << "scan method:" << endl;
+    cout << std::left << setw(lw) << "" << "  arp    ARP requests on raw sockets, requires CAP_NET_RAW (default)" << endl;
+    cout << std::left << setw(lw) << "" << "  neigh  unprivileged, kernel address resolution triggered by UDP datagrams" << endl;
+    cout << std::left << setw(lw) << "" << "  icmp   ICMP echo requests, for routed subnets" << endl;
+    cout << std::left << setw(lw) << "" << "  tcp    TCP connects, for hosts which filter ICMP" << endl;
+    cout << std::left << setw(lw) << std::string("  ") + argstr::ports + "=LIST" << "comma separated TCP ports for --mode=tcp (default 22,80,443,445,3389,8080)" << endl;
+    cout << std::left << setw(lw) << std::string("  ") + argstr::ring << "sweep using memory mapped TX/RX rings (PACKET_MMAP)" << endl;
+    cout << std::left << setw(lw) << std::string("  ") + argstr::batch + "=N" << "send and receive N frames per syscall (sendmmsg/recvmmsg)" << endl;
+    cout << std::left << setw(lw) << std::string("  ") + argstr::fanout + "=N" << "ARP sweep on N threads pinned to cores, the replies are split by PACKET_FANOUT" << endl;
+    cout << std::left << setw(lw) << std::string("  ") + argstr::uring << "ICMP sweep through io_uring, falls back to sockets if not supported" << endl;
+    cout << std::left << setw(lw) << std::string("  ") + argstr::noNeigh << "probe hosts which are in the neighbour table too" << endl;
+    cout << std::left << setw(lw) << std::string("  ") + argstr::rate + "=PPS" << "send at most PPS probes per second" << endl;
+    cout << std::left << setw(lw) << std::string("  ") + argstr::burst + "=N" << "send up to N probes back to back within the rate (default " << app::Options::default_burst << ")" << endl;
+#else
+    cout << std::left << setw(lw) << std::string("  ") + argstr::jobs + "=N" << "number of scan threads (default " << app::Options::jobs_per_core << " per core)" << endl;
+#endif
     cout << endl;
     cout << "Website: <" << prj::website << ">" << endl;
 }
@@ -104,6 +196,238 @@ void printUsageAndTryHelp()
     cout << "Try '" << prj::exeName << " --help' for more options." << endl;
 }
 
+/**
+ * Reads the scan options from the arguments. Prints an error message and returns `false` if an option has an invalid value.
+ */
+bool getOptions(const std::vector<std::string>& args, app::Options& options)
+{
+    options.setStats(argstr::contains(args, argstr::stats));
+    options.setNeighCache(!argstr::contains(args, argstr::noNeigh));
+
+    const std::string modeStr = argstr::value(args, argstr::mode);
+    if (modeStr == "neigh") { options.setMode(app::ScanMode::neigh); }
+    else if (modeStr == "icmp") { options.setMode(app::ScanMode::icmp); }
+    else if (modeStr == "tcp") { options.setMode(app::ScanMode::tcp); }
+    else if (!modeStr.empty() && (modeStr != "arp"))
+    {
+        cout << "unknown scan method: " << modeStr << endl;
+        return false;
+    }
+
+    if (argstr::contains(args, argstr::ring)) { options.setArpIo(app::ArpIo::ring); }
+
+    const std::string batchStr = argstr::value(args, argstr::batch);
+    if (!batchStr.empty())
+    {
+        constexpr int maxBatchSize = 1024; // UIO_MAXIOV
+
+        const int batchSize = (omw::isUInteger(batchStr) && (batchStr.size() <= 4) ? std::stoi(batchStr) : 0);
+        if ((batchSize < 1) || (batchSize > maxBatchSize))
+        {
+            cout << "invalid batch size: " << batchStr << " (1.." << maxBatchSize << ")" << endl;
+            return false;
+        }
+
+        if (options.arpIo() == app::ArpIo::ring)
+        {
+            cout << argstr::ring << " and " << argstr::batch << " can't be combined" << endl;
+            return false;
+        }
+
+        options.setArpIo(app::ArpIo::batch);
+        options.setBatchSize((size_t)batchSize);
+    }
+
+    const std::string fanoutStr = argstr::value(args, argstr::fanout);
+    if (!fanoutStr.empty())
+    {
+        constexpr int maxFanout = 256; // PACKET_FANOUT_MAX before Linux 5.9
+
+        const int fanout = (omw::isUInteger(fanoutStr) && (fanoutStr.size() <= 3) ? std::stoi(fanoutStr) : 0);
+        if ((fanout < 1) || (fanout > maxFanout))
+        {
+            cout << "invalid fanout: " << fanoutStr << " (1.." << maxFanout << ")" << endl;
+            return false;
+        }
+
+        // only the ARP sweep runs on multiple threads
+        if (options.mode() != app::ScanMode::arp)
+        {
+            cout << argstr::fanout << " can't be combined with " << argstr::mode << "=" << modeStr << endl;
+            return false;
+        }
+
+        options.setFanout((size_t)fanout);
+    }
+
+    options.setUring(argstr::contains(args, argstr::uring));
+
+    const std::string rateStr = argstr::value(args, argstr::rate);
+    if (!rateStr.empty())
+    {
+        constexpr int maxRate = 10000000;
+
+        const int rate = (omw::isUInteger(rateStr) && (rateStr.size() <= 8) ? std::stoi(rateStr) : 0);
+        if ((rate < 1) || (rate > maxRate))
+        {
+            cout << "invalid rate: " << rateStr << " (1.." << maxRate << ")" << endl;
+            return false;
+        }
+
+        // each fanout thread sends at least one probe per second
+        if ((size_t)rate < options.fanout())
+        {
+            cout << argstr::rate << " has to be at least " << argstr::fanout << " (" << options.fanout() << ")" << endl;
+            return false;
+        }
+
+        options.setRate((uint32_t)rate);
+    }
+
+    const std::string burstStr = argstr::value(args, argstr::burst);
+    if (!burstStr.empty())
+    {
+        constexpr int maxBurst = 100000;
+
+        const int burst = (omw::isUInteger(burstStr) && (burstStr.size() <= 6) ? std::stoi(burstStr) : 0);
+        if ((burst < 1) || (burst > maxBurst))
+        {
+            cout << "invalid burst: " << burstStr << " (1.." << maxBurst << ")" << endl;
+            return false;
+        }
+
+        if (options.rate() == 0)
+        {
+            cout << argstr::burst << " requires " << argstr::rate << endl;
+            return false;
+        }
+
+        options.setBurst((size_t)burst);
+    }
+
+    const std::string portsStr = argstr::value(args, argstr::ports);
+    if (!portsStr.empty())
+    {
+        std::vector<uint16_t> ports;
+
+        for (const auto& token : omw::split(portsStr, ','))
+        {
+            const int port = (omw::isUInteger(token) && (token.size() <= 5) ? std::stoi(token) : 0);
+            if ((port < 1) || (port > 65535))
+            {
+                cout << "invalid port: " << token << endl;
+                return false;
+            }
+
+            if (std::find(ports.begin(), ports.end(), (uint16_t)port) == ports.end()) { ports.push_back((uint16_t)port); }
+        }
+
+        options.setPorts(ports);
+    }
+
+    options.setExcludeFile(argstr::value(args, argstr::excludeFile));
+
+    bool inputList = false;
+    bool stdinList = false;
+    for (size_t i = 0; i < args.size(); ++i)
+    {
+        if (args[i] == argstr::inputList)
+        {
+            if ((i + 1) >= args.size())
+            {
+                cout << argstr::inputList << " requires a file name" << endl;
+                return false;
+            }
+
+            options.setInputFile(args[i + 1]);
+            inputList = true;
+        }
+        else if ((args[i] == argstr::stdinList) && !argstr::isInputListValue(args, i)) { stdinList = true; }
+    }
+
+    if (inputList && stdinList)
+    {
+        cout << argstr::inputList << " and " << argstr::stdinList << " can't be combined" << endl;
+        return false;
+    }
+    else if (stdinList) { options.setInputFile("-"); }
+
+    const std::string seedStr = argstr::value(args, argstr::randomize);
+    if (!seedStr.empty())
+    {
+        if (!omw::isUInteger(seedStr) || (seedStr.size() > 19))
+        {
+            cout << "invalid seed: " << seedStr << endl;
+            return false;
+        }
+
+        options.setRandomize(true);
+        options.setSeed(std::stoull(seedStr));
+    }
+    else if (argstr::contains(args, argstr::randomize))
+    {
+        // a new order on every run, the seed is printed so that it can be repeated
+        std::random_device rd;
+        options.setRandomize(true);
+        options.setSeed(((uint64_t)rd() << 32) | rd());
+    }
+
+    options.setSorted(argstr::contains(args, argstr::sorted));
+    if (options.sorted() && options.randomize())
+    {
+        cout << argstr::sorted << " can't be combined with " << argstr::randomize << endl;
+        return false;
+    }
+
+    const std::string shardStr = argstr::value(args, argstr::shard);
+    if (!shardStr.empty())
+    {
+        constexpr int maxShards = 65535;
+
+        const auto tokens = omw::split(shardStr, '/');
+        const bool valid = ((tokens.size() == 2) && omw::isUInteger(tokens[0]) && (tokens[0].size() <= 5) && omw::isUInteger(tokens[1]) &&
+                            (tokens[1].size() <= 5));
+        const int index = (valid ? std::stoi(tokens[0]) : 0);
+        const int count = (valid ? std::stoi(tokens[1]) : 0);
+
+        if ((index < 1) || (count < 1) || (index > count) || (count > maxShards))
+        {
+            cout << "invalid shard: " << shardStr << " (I/N with 1 <= I <= N <= " << maxShards << ")" << endl;
+            return false;
+        }
+
+        // every instance has to generate the same order
+        if (options.randomize() && seedStr.empty() && (count > 1))
+        {
+            cout << argstr::shard << " requires the same seed for all shards, e.g. " << argstr::randomize << "=" << options.seed() << endl;
+            return false;
+        }
+
+        options.setShard((size_t)(index - 1), (size_t)count);
+    }
+
+    const std::string checkpointStr = argstr::value(args, argstr::checkpoint);
+    if (!checkpointStr.empty()) { options.setCheckpointFile(checkpointStr); }
+    options.setResume(argstr::contains(args, argstr::resume));
+
+    const std::string jobsStr = argstr::value(args, argstr::jobs);
+    if (!jobsStr.empty())
+    {
+        constexpr int maxJobs = 1024;
+
+        const int jobs = (omw::isUInteger(jobsStr) && (jobsStr.size() <= 4) ? std::stoi(jobsStr) : 0);
+        if ((jobs < 1) || (jobs > maxJobs))
+        {
+            cout << "invalid number of jobs: " << jobsStr << " (1.." << maxJobs << ")" << endl;
+            return false;
+        }
+
+        options.setJobs((size_t)jobs);
+    }
+
+    return true;
+}
+
 void printVersion()
 {
     const omw::Version& v = prj::version;
@@ -190,8 +514,9 @@ int main(int argc, char** argv)
 
 
     int r = EC_ERROR;
+    app::Options options;
 
-    if (/*args.isValid()*/ argstr::check(args))
+    if (/*args.isValid()*/ argstr::check(args) && getOptions(args, options))
     {
         r = EC_OK;
 
@@ -204,17 +529,18 @@ int main(int argc, char** argv)
             app::cache::load();
             std::thread thread_curl = std::thread(curl::thread);
 
+            std::vector<std::string> addrArgs;
             for (size_t i = 0; i < args.size(); ++i)
             {
-                const auto& arg = args[i];
-
-                if (!argstr::isOption(arg))
-                {
-                    const int err = app::process(arg);
-                    if (err) { r = EC_ERROR; }
-                }
+                if (!argstr::isOption(args[i]) && !argstr::isInputListValue(args, i)) { addrArgs.push_back(args[i]); }
             }
 
+            // the first SIGINT ends the sweep cleanly, the second one terminates
+            interrupt::install();
+
+            const int err = app::process(addrArgs, options);
+            if (err) { r = EC_ERROR; }
+
             curl::shutdown();
             thread_curl.join();
 
@@ -274,7 +600,7 @@ bool argstr::check(const std::vector<std::string>& args)
         {
             const auto& arg = args[i];
 
-            if (!argstr::isKnownOption(arg) && argstr::isOption(arg))
+            if (!argstr::isKnownOption(arg) && argstr::isOption(arg) && !argstr::isInputListValue(args, i))
             {
                 ok = false;
 
@@ -0,0 +1,87 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "addr-set.h"
+#include "ip-addr.h"
+
+
+
+void ip::AddrSet4::add(const ip::Addr4& first, const ip::Addr4& last)
+{
+    if (first.value() <= last.value()) { m_intervals.push_back(Interval{ first.value(), last.value() }); }
+}
+
+void ip::AddrSet4::normalize()
+{
+    if (m_intervals.empty()) { return; }
+
+    std::sort(m_intervals.begin(), m_intervals.end(), [](const Interval& a, const Interval& b) { return (a.first < b.first); });
+
+    size_t n = 0;
+
+    for (size_t i = 1; i < m_intervals.size(); ++i)
+    {
+        Interval& cur = m_intervals[n];
+        const Interval& iv = m_intervals[i];
+
+        // 64bit, so that the end of the address space doesn't overflow
+        if ((uint64_t)iv.first <= ((uint64_t)cur.last + 1)) { cur.last = std::max(cur.last, iv.last); }
+        else { m_intervals[++n] = iv; }
+    }
+
+    m_intervals.resize(n + 1);
+}
+
+void ip::AddrSet4::subtract(const ip::AddrSet4& other)
+{
+    std::vector<Interval> result;
+    result.reserve(m_intervals.size());
+
+    size_t j = 0;
+    const auto& ex = other.m_intervals;
+
+    for (const auto& iv : m_intervals)
+    {
+        uint64_t first = iv.first;
+        const uint64_t last = iv.last;
+
+        // skip the exclusions which end before this interval
+        while ((j < ex.size()) && (ex[j].last < first)) { ++j; }
+
+        size_t k = j;
+        while ((k < ex.size()) && (ex[k].first <= last) && (first <= last))
+        {
+            if (ex[k].first > first) { result.push_back(Interval{ (Addr4::value_type)first, ex[k].first - 1 }); }
+            first = (uint64_t)ex[k].last + 1;
+            ++k;
+        }
+
+        if (first <= last) { result.push_back(Interval{ (Addr4::value_type)first, (Addr4::value_type)last }); }
+    }
+
+    m_intervals.swap(result);
+}
+
+bool ip::AddrSet4::contains(const ip::Addr4& addr) const
+{
+    // first interval which starts after `addr`, the one before it is the only candidate
+    const auto it = std::upper_bound(m_intervals.begin(), m_intervals.end(), addr.value(),
+                                     [](Addr4::value_type value, const Interval& iv) { return (value < iv.first); });
+
+    return ((it != m_intervals.begin()) && ((it - 1)->last >= addr.value()));
+}
+
+uint64_t ip::AddrSet4::size() const
+{
+    uint64_t n = 0;
+    for (const auto& iv : m_intervals) { n += (uint64_t)iv.last - iv.first + 1; }
+    return n;
+}
@@ -0,0 +1,81 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_MIDDLEWARE_ADDRSET_H
+#define IG_MIDDLEWARE_ADDRSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ip-addr.h"
+
+
+namespace ip {
+
+/**
+ * @brief Set of IPv4 addresses, stored as sorted disjoint intervals.
+ *
+ * Intervals are added unordered and may overlap, `normalize()` sorts and merges them. All other operations require a
+ * normalized set. The memory usage depends on the number of intervals only, not on the number of addresses.
+ */
+class AddrSet4
+{
+public:
+    /**
+     * @brief Inclusive address interval.
+     */
+    struct Interval
+    {
+        Addr4::value_type first;
+        Addr4::value_type last;
+    };
+
+public:
+    AddrSet4()
+        : m_intervals()
+    {}
+
+    virtual ~AddrSet4() {}
+
+    /**
+     * Adds the addresses from `first` to `last`, both inclusive.
+     */
+    void add(const ip::Addr4& first, const ip::Addr4& last);
+
+    /**
+     * Adds the addresses of the subnet, including the network and broadcast address.
+     */
+    void add(const ip::Addr4& network, const ip::SubnetMask4& mask) { this->add(network & mask, network | ~mask); }
+
+    /**
+     * Sorts the intervals and merges the ones which overlap or are adjacent.
+     */
+    void normalize();
+
+    /**
+     * Removes the addresses of `other`, which has to be normalized too. Linear in the number of intervals of both sets.
+     */
+    void subtract(const ip::AddrSet4& other);
+
+    /**
+     * Binary search, logarithmic in the number of intervals.
+     */
+    bool contains(const ip::Addr4& addr) const;
+
+    bool empty() const { return m_intervals.empty(); }
+    uint64_t size() const; ///< number of addresses
+
+    const std::vector<Interval>& intervals() const { return m_intervals; }
+
+private:
+    std::vector<Interval> m_intervals;
+};
+
+} // namespace ip
+
+
+#endif // IG_MIDDLEWARE_ADDRSET_H
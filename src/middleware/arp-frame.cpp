@@ -0,0 +1,78 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#include <cstddef>
+#include <cstdint>
+
+#include "arp-frame.h"
+#include "ip-addr.h"
+#include "mac-addr.h"
+
+
+
+static void write16(uint8_t* p, uint16_t value)
+{
+    p[0] = (uint8_t)(value >> 8);
+    p[1] = (uint8_t)(value);
+}
+
+static uint16_t read16(const uint8_t* p) { return (((uint16_t)p[0] << 8) | (uint16_t)p[1]); }
+
+static void writeIP(uint8_t* p, const ip::Addr4& addr)
+{
+    p[0] = addr.octetHigh();
+    p[1] = addr.octetMidHi();
+    p[2] = addr.octetMidLo();
+    p[3] = addr.octetLow();
+}
+
+static ip::Addr4 readIP(const uint8_t* p) { return ip::Addr4(p[0], p[1], p[2], p[3]); }
+
+
+
+void arp::buildRequest(uint8_t* frame, const mac::Addr& sha, const ip::Addr4& spa, const ip::Addr4& tpa)
+{
+    // Ethernet header
+    for (size_t i = 0; i < mac::Addr::size(); ++i)
+    {
+        frame[i] = mac::Addr::broadcast[i];
+        frame[6 + i] = sha[i];
+    }
+    write16(frame + 12, arp::ethertype);
+
+    // ARP packet
+    write16(frame + 14, 1);      // HTYPE Ethernet
+    write16(frame + 16, 0x0800); // PTYPE IPv4
+    frame[18] = 6;               // HLEN
+    frame[19] = 4;               // PLEN
+    write16(frame + 20, arp::op_request);
+    for (size_t i = 0; i < mac::Addr::size(); ++i)
+    {
+        frame[22 + i] = sha[i];
+        frame[32 + i] = 0;
+    }
+    writeIP(frame + arp::spa_offset, spa);
+    writeIP(frame + arp::tpa_offset, tpa);
+}
+
+void arp::setTargetIP(uint8_t* frame, const ip::Addr4& tpa) { writeIP(frame + arp::tpa_offset, tpa); }
+
+bool arp::parseReply(const uint8_t* frame, size_t size, mac::Addr& sha, ip::Addr4& spa, ip::Addr4& tpa)
+{
+    if ((size < arp::frame_size) || (read16(frame + 12) != arp::ethertype)) { return false; }
+
+    if ((read16(frame + 14) != 1) || (read16(frame + 16) != 0x0800) || (frame[18] != 6) || (frame[19] != 4) ||
+        (read16(frame + 20) != arp::op_reply))
+    {
+        return false;
+    }
+
+    sha.set(frame + 22);
+    spa = readIP(frame + arp::spa_offset);
+    tpa = readIP(frame + arp::tpa_offset);
+
+    return true;
+}
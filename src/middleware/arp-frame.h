@@ -0,0 +1,50 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_MIDDLEWARE_ARPFRAME_H
+#define IG_MIDDLEWARE_ARPFRAME_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "middleware/ip-addr.h"
+#include "middleware/mac-addr.h"
+
+
+/**
+ * @brief Ethernet II frames carrying IPv4 over Ethernet ARP packets (RFC 826).
+ */
+namespace arp {
+
+constexpr uint16_t ethertype = 0x0806;
+
+constexpr uint16_t op_request = 1;
+constexpr uint16_t op_reply = 2;
+
+constexpr size_t frame_size = 42; ///< 14 bytes Ethernet header + 28 bytes ARP packet, padding is added by the NIC
+
+constexpr size_t spa_offset = 28; ///< offset of the sender protocol address in the frame
+constexpr size_t tpa_offset = 38; ///< offset of the target protocol address in the frame
+
+/**
+ * Writes a broadcast ARP request with target IP `tpa` into `frame`, which has to be at least `arp::frame_size` bytes.
+ */
+void buildRequest(uint8_t* frame, const mac::Addr& sha, const ip::Addr4& spa, const ip::Addr4& tpa);
+
+/**
+ * Patches the target IP of a frame created by `arp::buildRequest()`.
+ */
+void setTargetIP(uint8_t* frame, const ip::Addr4& tpa);
+
+/**
+ * Returns `true` if `frame` is an ARP reply. The sender addresses are written to `sha` and `spa`, the target IP to `tpa`.
+ */
+bool parseReply(const uint8_t* frame, size_t size, mac::Addr& sha, ip::Addr4& spa, ip::Addr4& tpa);
+
+} // namespace arp
+
+
+#endif // IG_MIDDLEWARE_ARPFRAME_H
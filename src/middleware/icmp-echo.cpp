@@ -0,0 +1,80 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#include <cstddef>
+#include <cstdint>
+
+#include "icmp-echo.h"
+#include "ip-addr.h"
+
+
+
+static void write16(uint8_t* p, uint16_t value)
+{
+    p[0] = (uint8_t)(value >> 8);
+    p[1] = (uint8_t)(value);
+}
+
+static void write32(uint8_t* p, uint32_t value)
+{
+    write16(p, (uint16_t)(value >> 16));
+    write16(p + 2, (uint16_t)(value));
+}
+
+static uint16_t read16(const uint8_t* p) { return (((uint16_t)p[0] << 8) | (uint16_t)p[1]); }
+static uint32_t read32(const uint8_t* p) { return (((uint32_t)read16(p) << 16) | (uint32_t)read16(p + 2)); }
+
+/**
+ * Internet checksum (RFC 1071).
+ */
+static uint16_t checksum(const uint8_t* data, size_t size)
+{
+    uint32_t sum = 0;
+
+    for (size_t i = 0; (i + 1) < size; i += 2) { sum += read16(data + i); }
+    if (size & 1) { sum += ((uint32_t)data[size - 1] << 8); }
+
+    while (sum >> 16) { sum = (sum & 0xFFFF) + (sum >> 16); }
+
+    return (uint16_t)(~sum);
+}
+
+
+
+void icmp::buildEchoRequest(uint8_t* packet, uint16_t id, uint16_t seq, uint32_t cookie, const ip::Addr4& target)
+{
+    packet[0] = icmp::type_echo_request;
+    packet[1] = 0; // code
+    write16(packet + 2, 0);
+    write16(packet + 4, id);
+    write16(packet + 6, seq);
+    write32(packet + 8, cookie);
+    write32(packet + 12, target.value());
+
+    write16(packet + 2, checksum(packet, icmp::echo_size));
+}
+
+bool icmp::parseEchoReply(const uint8_t* packet, size_t size, uint32_t cookie, uint16_t& id, ip::Addr4& target)
+{
+    if ((size < icmp::echo_size) || (packet[0] != icmp::type_echo_reply) || (packet[1] != 0)) { return false; }
+
+    if (read32(packet + 8) != cookie) { return false; }
+
+    id = read16(packet + 4);
+    target = ip::Addr4(read32(packet + 12));
+
+    return true;
+}
+
+size_t icmp::ipHeaderSize(const uint8_t* packet, size_t size)
+{
+    if ((size < 20) || ((packet[0] >> 4) != 4)) { return 0; }
+
+    const size_t ihl = (size_t)(packet[0] & 0x0F) * 4;
+    if ((ihl < 20) || (ihl > size) || (packet[9] != 1)) { return 0; } // protocol ICMP
+
+    return ihl;
+}
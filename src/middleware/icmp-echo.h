@@ -0,0 +1,49 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_MIDDLEWARE_ICMPECHO_H
+#define IG_MIDDLEWARE_ICMPECHO_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "middleware/ip-addr.h"
+
+
+/**
+ * @brief ICMP echo request and reply messages (RFC 792).
+ *
+ * The payload carries a cookie, which identifies the messages of this process, and the address of the target. With the
+ * target in the payload a reply can be matched without keeping track of the sequence numbers.
+ */
+namespace icmp {
+
+constexpr uint8_t type_echo_reply = 0;
+constexpr uint8_t type_echo_request = 8;
+
+constexpr size_t header_size = 8;
+constexpr size_t echo_size = header_size + 8; ///< header + cookie + target address
+
+/**
+ * Writes an echo request into `packet`, which has to be at least `icmp::echo_size` bytes.
+ */
+void buildEchoRequest(uint8_t* packet, uint16_t id, uint16_t seq, uint32_t cookie, const ip::Addr4& target);
+
+/**
+ * Returns `true` if `packet` is an echo reply with the given `cookie`. `packet` is the ICMP message without IP header.
+ * The identifier and the target address are written to `id` and `target`.
+ */
+bool parseEchoReply(const uint8_t* packet, size_t size, uint32_t cookie, uint16_t& id, ip::Addr4& target);
+
+/**
+ * Returns the size of the IPv4 header of `packet`, or 0 if it's not a valid ICMP over IPv4 packet.
+ */
+size_t ipHeaderSize(const uint8_t* packet, size_t size);
+
+} // namespace icmp
+
+
+#endif // IG_MIDDLEWARE_ICMPECHO_H
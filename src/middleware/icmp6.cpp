@@ -0,0 +1,115 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#include <cstddef>
+#include <cstdint>
+
+#include "icmp6.h"
+#include "ip-addr.h"
+#include "mac-addr.h"
+
+
+
+namespace {
+
+constexpr uint8_t option_source_lladdr = 1;
+constexpr uint8_t option_target_lladdr = 2;
+
+constexpr size_t nd_header_size = 8 + ip::Addr6::octet_count; // header + reserved/flags + target address
+
+} // namespace
+
+
+
+static void write16(uint8_t* p, uint16_t value)
+{
+    p[0] = (uint8_t)(value >> 8);
+    p[1] = (uint8_t)(value);
+}
+
+static void write32(uint8_t* p, uint32_t value)
+{
+    write16(p, (uint16_t)(value >> 16));
+    write16(p + 2, (uint16_t)(value));
+}
+
+static uint16_t read16(const uint8_t* p) { return (((uint16_t)p[0] << 8) | (uint16_t)p[1]); }
+static uint32_t read32(const uint8_t* p) { return (((uint32_t)read16(p) << 16) | (uint32_t)read16(p + 2)); }
+
+/**
+ * Returns a pointer to the link layer address of the option of type `type`, `nullptr` if there is none.
+ */
+static const uint8_t* findLinkLayerOption(const uint8_t* options, size_t size, uint8_t type);
+
+
+
+void icmp6::buildEchoRequest(uint8_t* packet, uint16_t id, uint16_t seq, uint32_t cookie)
+{
+    packet[0] = icmp6::type_echo_request;
+    packet[1] = 0; // code
+    write16(packet + 2, 0);
+    write16(packet + 4, id);
+    write16(packet + 6, seq);
+    write32(packet + 8, cookie);
+}
+
+bool icmp6::parseEchoReply(const uint8_t* packet, size_t size, uint32_t cookie, uint16_t& id, uint16_t& seq)
+{
+    if ((size < icmp6::echo_size) || (packet[0] != icmp6::type_echo_reply) || (packet[1] != 0)) { return false; }
+
+    if (read32(packet + 8) != cookie) { return false; }
+
+    id = read16(packet + 4);
+    seq = read16(packet + 6);
+
+    return true;
+}
+
+bool icmp6::parseNeighbourMessage(const uint8_t* packet, size_t size, const ip::Addr6& src, ip::Addr6& ip, mac::Addr& mac)
+{
+    if ((size < nd_header_size) || (packet[1] != 0)) { return false; }
+
+    const uint8_t* lladdr = nullptr;
+
+    if (packet[0] == icmp6::type_neighbour_solicitation)
+    {
+        // the source of a duplicate address detection is unspecified
+        if (src == ip::Addr6::null) { return false; }
+
+        lladdr = findLinkLayerOption(packet + nd_header_size, size - nd_header_size, option_source_lladdr);
+        ip = src;
+    }
+    else if (packet[0] == icmp6::type_neighbour_advertisement)
+    {
+        lladdr = findLinkLayerOption(packet + nd_header_size, size - nd_header_size, option_target_lladdr);
+        ip = ip::Addr6(packet + 8);
+    }
+
+    if (!lladdr) { return false; }
+
+    mac.set(lladdr);
+
+    return true;
+}
+
+
+
+const uint8_t* findLinkLayerOption(const uint8_t* options, size_t size, uint8_t type)
+{
+    size_t pos = 0;
+
+    while ((pos + 2) <= size)
+    {
+        const size_t len = (size_t)options[pos + 1] * 8; // in units of 8 bytes
+        if ((len == 0) || ((pos + len) > size)) { break; }
+
+        if ((options[pos] == type) && (len >= (2 + mac::Addr::size()))) { return (options + pos + 2); }
+
+        pos += len;
+    }
+
+    return nullptr;
+}
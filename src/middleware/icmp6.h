@@ -0,0 +1,52 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_MIDDLEWARE_ICMP6_H
+#define IG_MIDDLEWARE_ICMP6_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "middleware/ip-addr.h"
+#include "middleware/mac-addr.h"
+
+
+/**
+ * @brief ICMPv6 echo (RFC 4443) and neighbour discovery (RFC 4861) messages.
+ *
+ * The checksum of ICMPv6 messages covers the IPv6 pseudo header, it's computed by the kernel.
+ */
+namespace icmp6 {
+
+constexpr uint8_t type_echo_request = 128;
+constexpr uint8_t type_echo_reply = 129;
+constexpr uint8_t type_neighbour_solicitation = 135;
+constexpr uint8_t type_neighbour_advertisement = 136;
+
+constexpr size_t echo_size = 8 + 4; ///< header + cookie
+
+/**
+ * Writes an echo request into `packet`, which has to be at least `icmp6::echo_size` bytes.
+ */
+void buildEchoRequest(uint8_t* packet, uint16_t id, uint16_t seq, uint32_t cookie);
+
+/**
+ * Returns `true` if `packet` is an echo reply with the given `cookie`, the identifier is written to `id` and the sequence
+ * number to `seq`.
+ */
+bool parseEchoReply(const uint8_t* packet, size_t size, uint32_t cookie, uint16_t& id, uint16_t& seq);
+
+/**
+ * Returns `true` if `packet` is a neighbour solicitation or advertisement which carries the link layer address of a
+ * node. This is the source link-layer address option of a solicitation sent by `src`, or the target link-layer address
+ * option of an advertisement. The address of the node is written to `ip` and its link layer address to `mac`.
+ */
+bool parseNeighbourMessage(const uint8_t* packet, size_t size, const ip::Addr6& src, ip::Addr6& ip, mac::Addr& mac);
+
+} // namespace icmp6
+
+
+#endif // IG_MIDDLEWARE_ICMP6_H
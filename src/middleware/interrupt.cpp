@@ -0,0 +1,37 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#include <atomic>
+#include <csignal>
+
+#include "interrupt.h"
+
+
+
+static std::atomic<bool> flag(false);
+static_assert(std::atomic<bool>::is_always_lock_free, "the flag is set in a signal handler");
+
+static void handler(int sig);
+
+
+
+void interrupt::install()
+{
+    std::signal(SIGINT, handler);
+    std::signal(SIGTERM, handler);
+}
+
+bool interrupt::requested() { return flag.load(); }
+
+
+
+void handler(int sig)
+{
+    flag.store(true);
+
+    // the next signal isn't caught, in case draining takes too long
+    std::signal(sig, SIG_DFL);
+}
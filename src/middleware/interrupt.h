@@ -0,0 +1,27 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_MIDDLEWARE_INTERRUPT_H
+#define IG_MIDDLEWARE_INTERRUPT_H
+
+
+namespace interrupt {
+
+/**
+ * Installs the handler of `SIGINT` and `SIGTERM`. The first signal only sets the flag returned by `requested()`, a
+ * second one terminates the process as usual.
+ */
+void install();
+
+/**
+ * Returns `true` once a signal has been received. Safe to call from any thread.
+ */
+bool requested();
+
+} // namespace interrupt
+
+
+#endif // IG_MIDDLEWARE_INTERRUPT_H
@@ -0,0 +1,310 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "cli.h"
+#include "io-uring.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+
+namespace {
+
+constexpr unsigned int cqEntriesFactor = 8; // a multishot receive completes once per packet, not once per request
+
+}
+
+
+
+static inline uint32_t loadIndex(const uint32_t* index) { return __atomic_load_n(index, __ATOMIC_ACQUIRE); }
+static inline void storeIndex(uint32_t* index, uint32_t value) { __atomic_store_n(index, value, __ATOMIC_RELEASE); }
+
+static void* mapAnonymous(size_t size);
+
+
+
+IoUring::IoUring()
+    : m_fd(-1),
+      m_sqMap(nullptr),
+      m_sqMapSize(0),
+      m_cqMap(nullptr),
+      m_cqMapSize(0),
+      m_sqes(nullptr),
+      m_sqesSize(0),
+      m_sqHead(nullptr),
+      m_sqTail(nullptr),
+      m_sqFlags(nullptr),
+      m_sqArray(nullptr),
+      m_sqMask(0),
+      m_sqEntries(0),
+      m_sqLocalTail(0),
+      m_sqPending(0),
+      m_cqHead(nullptr),
+      m_cqTail(nullptr),
+      m_cqes(nullptr),
+      m_cqMask(0),
+      m_bufRing(nullptr),
+      m_bufRingSize(0),
+      m_buffers(nullptr),
+      m_bufferSize(0),
+      m_bufferCount(0),
+      m_bufTail(0),
+      m_syscalls(0)
+{}
+
+IoUring::~IoUring() { this->close(); }
+
+int IoUring::open(unsigned int entries)
+{
+    this->close();
+
+    struct io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = entries * cqEntriesFactor;
+
+    m_fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (m_fd < 0) { return errno; }
+
+    // overflowing completions are kept by the kernel instead of being dropped, since Linux 5.5
+    if ((params.features & IORING_FEAT_NODROP) == 0)
+    {
+        this->close();
+        return ENOTSUP;
+    }
+
+    m_sqMapSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    m_cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+    // both rings are in one mapping since Linux 5.4
+    if (params.features & IORING_FEAT_SINGLE_MMAP) { m_sqMapSize = m_cqMapSize = std::max(m_sqMapSize, m_cqMapSize); }
+
+    void* map = mmap(nullptr, m_sqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+    if (map == MAP_FAILED)
+    {
+        const int err = errno;
+        m_sqMapSize = 0;
+        this->close();
+        return err;
+    }
+
+    m_sqMap = (uint8_t*)map;
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        m_cqMap = m_sqMap;
+        m_cqMapSize = 0; // unmapped with the SQ ring
+    }
+    else
+    {
+        map = mmap(nullptr, m_cqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+        if (map == MAP_FAILED)
+        {
+            const int err = errno;
+            m_cqMapSize = 0;
+            this->close();
+            return err;
+        }
+
+        m_cqMap = (uint8_t*)map;
+    }
+
+    m_sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    map = mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+    if (map == MAP_FAILED)
+    {
+        const int err = errno;
+        m_sqesSize = 0;
+        this->close();
+        return err;
+    }
+
+    m_sqes = (struct io_uring_sqe*)map;
+
+    m_sqHead = (const uint32_t*)(m_sqMap + params.sq_off.head);
+    m_sqTail = (uint32_t*)(m_sqMap + params.sq_off.tail);
+    m_sqFlags = (const uint32_t*)(m_sqMap + params.sq_off.flags);
+    m_sqArray = (uint32_t*)(m_sqMap + params.sq_off.array);
+    m_sqMask = *(const uint32_t*)(m_sqMap + params.sq_off.ring_mask);
+    m_sqEntries = params.sq_entries;
+    m_sqLocalTail = *m_sqTail;
+    m_sqPending = 0;
+
+    m_cqHead = (uint32_t*)(m_cqMap + params.cq_off.head);
+    m_cqTail = (const uint32_t*)(m_cqMap + params.cq_off.tail);
+    m_cqes = (const struct io_uring_cqe*)(m_cqMap + params.cq_off.cqes);
+    m_cqMask = *(const uint32_t*)(m_cqMap + params.cq_off.ring_mask);
+
+    return 0;
+}
+
+int IoUring::provideBuffers(uint16_t group, size_t count, size_t size)
+{
+    if ((m_fd < 0) || (count == 0) || (count > 32768) || ((count & (count - 1)) != 0)) { return EINVAL; }
+
+    m_bufRingSize = count * sizeof(struct io_uring_buf);
+    m_bufRing = (struct io_uring_buf*)mapAnonymous(m_bufRingSize);
+    m_buffers = (uint8_t*)mapAnonymous(count * size);
+
+    if (!m_bufRing || !m_buffers)
+    {
+        const int err = errno;
+        this->close();
+        return err;
+    }
+
+    m_bufferSize = size;
+    m_bufferCount = count;
+
+    struct io_uring_buf_reg reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t)(uintptr_t)m_bufRing;
+    reg.ring_entries = (uint32_t)count;
+    reg.bgid = group;
+
+    // since Linux 5.19
+    ++m_syscalls;
+    if (syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0)
+    {
+        const int err = errno;
+        this->close();
+        return err;
+    }
+
+    m_bufTail = 0;
+    for (size_t i = 0; i < count; ++i) { this->recycle((uint16_t)i); }
+
+    return 0;
+}
+
+struct io_uring_sqe* IoUring::sqe()
+{
+    if ((m_sqLocalTail - loadIndex(m_sqHead)) >= m_sqEntries) { return nullptr; }
+
+    const uint32_t idx = m_sqLocalTail & m_sqMask;
+    struct io_uring_sqe* const e = &m_sqes[idx];
+    std::memset(e, 0, sizeof(*e));
+    m_sqArray[idx] = idx;
+
+    ++m_sqLocalTail;
+    ++m_sqPending;
+
+    return e;
+}
+
+int IoUring::submit()
+{
+    if (m_sqPending == 0) { return 0; }
+
+    storeIndex(m_sqTail, m_sqLocalTail);
+
+    const int r = this->enter(m_sqPending, 0);
+    if (r < 0)
+    {
+        // the entries stay in the queue and are submitted with the next call
+        if ((errno == EAGAIN) || (errno == EBUSY) || (errno == EINTR)) { return 0; }
+
+        cli::printError("io_uring_enter() failed", std::strerror(errno));
+        return -(__LINE__);
+    }
+
+    m_sqPending -= std::min(m_sqPending, (uint32_t)r);
+
+    return 0;
+}
+
+void IoUring::reap(const completion_handler& handler)
+{
+    while (true)
+    {
+        uint32_t head = *m_cqHead;
+        const uint32_t tail = loadIndex(m_cqTail);
+
+        while (head != tail)
+        {
+            const struct io_uring_cqe& cqe = m_cqes[head & m_cqMask];
+            const uint64_t userData = cqe.user_data;
+            const int32_t res = cqe.res;
+            const uint32_t flags = cqe.flags;
+
+            // the entry is released before the handler is called, which may submit new requests
+            storeIndex(m_cqHead, ++head);
+
+            handler(userData, res, flags);
+        }
+
+        // completions which didn't fit into the CQ ring are moved to it by the next `io_uring_enter()`
+        if ((__atomic_load_n(m_sqFlags, __ATOMIC_RELAXED) & IORING_SQ_CQ_OVERFLOW) == 0) { break; }
+        if (this->enter(0, IORING_ENTER_GETEVENTS) < 0) { break; }
+    }
+}
+
+void IoUring::recycle(uint16_t bid)
+{
+    struct io_uring_buf& buf = m_bufRing[m_bufTail & (m_bufferCount - 1)];
+    buf.addr = (uint64_t)(uintptr_t)(m_buffers + (size_t)bid * m_bufferSize);
+    buf.len = (uint32_t)m_bufferSize;
+    buf.bid = bid;
+
+    // the tail overlays the reserved field of the first entry, `io_uring_buf_ring` can't be used because the flexible
+    // array member of the header is at a different offset in C++
+    ++m_bufTail;
+    __atomic_store_n(&m_bufRing[0].resv, m_bufTail, __ATOMIC_RELEASE);
+}
+
+int IoUring::enter(uint32_t toSubmit, uint32_t flags)
+{
+    ++m_syscalls;
+    return (int)syscall(__NR_io_uring_enter, m_fd, toSubmit, 0, flags, nullptr, 0);
+}
+
+void IoUring::close()
+{
+    if (m_buffers)
+    {
+        munmap(m_buffers, m_bufferCount * m_bufferSize);
+        m_buffers = nullptr;
+    }
+
+    if (m_bufRing)
+    {
+        munmap(m_bufRing, m_bufRingSize);
+        m_bufRing = nullptr;
+    }
+
+    m_bufferSize = 0;
+    m_bufferCount = 0;
+
+    if (m_sqes) { munmap(m_sqes, m_sqesSize); }
+    if (m_cqMap && (m_cqMapSize > 0)) { munmap(m_cqMap, m_cqMapSize); }
+    if (m_sqMap) { munmap(m_sqMap, m_sqMapSize); }
+
+    m_sqes = nullptr;
+    m_cqMap = nullptr;
+    m_sqMap = nullptr;
+
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+
+
+void* mapAnonymous(size_t size)
+{
+    void* const map = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return (map == MAP_FAILED ? nullptr : map);
+}
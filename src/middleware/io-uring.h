@@ -0,0 +1,117 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_MIDDLEWARE_IOURING_H
+#define IG_MIDDLEWARE_IOURING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+
+struct io_uring_buf;
+struct io_uring_cqe;
+struct io_uring_sqe;
+
+/**
+ * @brief io_uring instance on the raw syscalls, with a ring of provided receive buffers.
+ *
+ * Requests are prepared in the memory mapped submission queue and submitted together by one `io_uring_enter()`, the
+ * completions are read from the completion queue without a syscall. The ring fd is readable while completions are
+ * ready, so it can be polled along with other fds.
+ */
+class IoUring
+{
+public:
+    using completion_handler = std::function<void(uint64_t userData, int32_t res, uint32_t flags)>;
+
+public:
+    IoUring();
+    virtual ~IoUring();
+
+    IoUring(const IoUring& other) = delete;
+    IoUring& operator=(const IoUring& other) = delete;
+
+    /**
+     * Sets up the rings with `entries` submission queue entries, a power of 2. Returns 0 on success, otherwise the
+     * `errno` of the failed call without printing an error, so that the caller can fall back to plain syscalls.
+     */
+    int open(unsigned int entries);
+
+    /**
+     * Registers `count` receive buffers of `size` bytes as buffer group `group`, for requests with `IOSQE_BUFFER_SELECT`.
+     * `count` has to be a power of 2. Returns 0 or the `errno` like `open()`.
+     */
+    int provideBuffers(uint16_t group, size_t count, size_t size);
+
+    int fd() const { return m_fd; }
+    size_t syscallCount() const { return m_syscalls; }
+
+    /**
+     * Returns the next free submission queue entry, cleared, or `nullptr` if the queue is full. The entry is submitted on
+     * the next call to `submit()`.
+     */
+    struct io_uring_sqe* sqe();
+
+    /**
+     * Submits all prepared entries without waiting for completions.
+     */
+    int submit();
+
+    /**
+     * Calls `handler` for every completion which is ready. `handler` may prepare new entries.
+     */
+    void reap(const completion_handler& handler);
+
+    /**
+     * Data of provided buffer `bid`, which is owned by user space from its completion until `recycle()`.
+     */
+    const uint8_t* buffer(uint16_t bid) const { return (m_buffers + (size_t)bid * m_bufferSize); }
+
+    /**
+     * Hands provided buffer `bid` back to the kernel.
+     */
+    void recycle(uint16_t bid);
+
+private:
+    int m_fd;
+
+    uint8_t* m_sqMap;
+    size_t m_sqMapSize;
+    uint8_t* m_cqMap;
+    size_t m_cqMapSize;
+    struct io_uring_sqe* m_sqes;
+    size_t m_sqesSize;
+
+    const uint32_t* m_sqHead;
+    uint32_t* m_sqTail;
+    const uint32_t* m_sqFlags;
+    uint32_t* m_sqArray;
+    uint32_t m_sqMask;
+    uint32_t m_sqEntries;
+    uint32_t m_sqLocalTail; // including the prepared entries
+    uint32_t m_sqPending;   // prepared entries which have not been submitted yet
+
+    uint32_t* m_cqHead;
+    const uint32_t* m_cqTail;
+    const struct io_uring_cqe* m_cqes;
+    uint32_t m_cqMask;
+
+    struct io_uring_buf* m_bufRing; // entries of the `io_uring_buf_ring`
+    size_t m_bufRingSize;
+    uint8_t* m_buffers;
+    size_t m_bufferSize;
+    size_t m_bufferCount;
+    uint16_t m_bufTail;
+
+    size_t m_syscalls;
+
+    int enter(uint32_t toSubmit, uint32_t flags);
+    void close();
+};
+
+
+#endif // IG_MIDDLEWARE_IOURING_H
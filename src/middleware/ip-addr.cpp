@@ -4,11 +4,14 @@ date            24.03.2025
 copyright       GPL-3.0 - Copyright (c) 2025 Oliver Blaser
 */
 
+#include <algorithm>
+#include <cctype>
 #include <cstddef>
 #include <cstdint>
 #include <mutex>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 
 #include "ip-addr.h"
@@ -149,6 +152,262 @@ void ip::SubnetMask4::check() const noexcept(false)
 
 
 
+const ip::Addr6 ip::Addr6::null = ip::Addr6();
+const ip::Addr6 ip::Addr6::max = ~ip::Addr6();
+const ip::Addr6 ip::Addr6::allNodes = ip::Addr6("ff02::1");
+
+void ip::Addr6::set(const std::string& str) noexcept(false)
+{
+    constexpr std::string_view fnName = "ip::Addr6::set";
+
+    // split at "::", the gap between head and tail is filled with zeros
+    const size_t gapPos = str.find("::");
+    if ((gapPos != std::string::npos) && (str.find("::", gapPos + 1) != std::string::npos)) { throw std::invalid_argument(fnName.data()); }
+
+    const std::string headStr = (gapPos != std::string::npos ? str.substr(0, gapPos) : str);
+    const std::string tailStr = (gapPos != std::string::npos ? str.substr(gapPos + 2) : std::string());
+
+    const auto parse = [fnName](const std::string& part, std::vector<uint16_t>& hextets, bool last) {
+        if (part.empty()) { return; }
+
+        const auto tokens = omw::split(part, ':');
+
+        for (size_t i = 0; i < tokens.size(); ++i)
+        {
+            const auto& token = tokens[i];
+
+            // embedded IPv4 address, e.g. `::ffff:192.168.1.1`
+            if (last && (i == (tokens.size() - 1)) && (token.find('.') != std::string::npos))
+            {
+                const ip::Addr4 addr4(token);
+                hextets.push_back((uint16_t)(addr4.value() >> 16));
+                hextets.push_back((uint16_t)(addr4.value()));
+            }
+            else if (!token.empty() && (token.size() <= 4) && std::all_of(token.begin(), token.end(), [](char c) { return (std::isxdigit((unsigned char)c) != 0); }))
+            {
+                hextets.push_back((uint16_t)std::stoul(token, nullptr, 16));
+            }
+            else { throw std::invalid_argument(fnName.data()); }
+        }
+    };
+
+    std::vector<uint16_t> head;
+    std::vector<uint16_t> tail;
+    parse(headStr, head, (gapPos == std::string::npos));
+    parse(tailStr, tail, true);
+
+    const size_t hextetCount = octet_count / 2;
+
+    if ((gapPos == std::string::npos) ? (head.size() != hextetCount) : ((head.size() + tail.size()) >= hextetCount))
+    {
+        throw std::invalid_argument(fnName.data());
+    }
+
+    value_type value{};
+
+    for (size_t i = 0; i < head.size(); ++i)
+    {
+        value[2 * i] = (uint8_t)(head[i] >> 8);
+        value[2 * i + 1] = (uint8_t)(head[i]);
+    }
+
+    for (size_t i = 0; i < tail.size(); ++i)
+    {
+        const size_t idx = hextetCount - tail.size() + i;
+        value[2 * idx] = (uint8_t)(tail[i] >> 8);
+        value[2 * idx + 1] = (uint8_t)(tail[i]);
+    }
+
+    this->set(value.data());
+}
+
+void ip::Addr6::set(const uint8_t* data) noexcept(false)
+{
+    for (size_t i = 0; i < octet_count; ++i) { m_value[i] = data[i]; }
+}
+
+std::string ip::Addr6::toString() const
+{
+    constexpr size_t hextetCount = octet_count / 2;
+
+    // the longest run of at least two zero hextets is compressed, the first one if there are multiple
+    size_t gapPos = hextetCount;
+    size_t gapLen = 0;
+
+    for (size_t i = 0; i < hextetCount;)
+    {
+        size_t len = 0;
+        while (((i + len) < hextetCount) && (this->hextet(i + len) == 0)) { ++len; }
+
+        if ((len >= 2) && (len > gapLen))
+        {
+            gapPos = i;
+            gapLen = len;
+        }
+
+        i += (len > 0 ? len : 1);
+    }
+
+    std::string str;
+
+    for (size_t i = 0; i < hextetCount; ++i)
+    {
+        if (i == gapPos)
+        {
+            str += "::";
+            i += gapLen - 1;
+            continue;
+        }
+
+        if (!str.empty() && (str.back() != ':')) { str += ':'; }
+
+        static const char hexDigits[] = "0123456789abcdef";
+        const uint16_t h = this->hextet(i);
+        bool leading = true;
+
+        for (int shift = 12; shift >= 0; shift -= 4)
+        {
+            const uint8_t nibble = (uint8_t)((h >> shift) & 0x0F);
+            if (leading && (nibble == 0) && (shift > 0)) { continue; }
+
+            leading = false;
+            str += hexDigits[nibble];
+        }
+    }
+
+    return str;
+}
+
+
+
+const ip::SubnetMask6 ip::SubnetMask6::null = ip::SubnetMask6(0);
+const ip::SubnetMask6 ip::SubnetMask6::max = ip::SubnetMask6((int)ip::Addr6::bit_count);
+
+void ip::SubnetMask6::set(const std::string& str) noexcept(false)
+{
+    constexpr std::string_view fnName = "ip::SubnetMask6::set";
+
+    const size_t slashPos = str.find('/');
+    if (slashPos == std::string::npos) { throw std::invalid_argument(fnName.data()); }
+
+    // check the format of IP
+    if (slashPos > 0)
+    {
+        try
+        {
+            const Addr6 ip = str.substr(0, slashPos);
+            (void)ip;
+        }
+        catch (const std::invalid_argument& ex)
+        {
+            if (omw::contains(ex.what(), "ip::")) { throw std::invalid_argument(fnName.data()); }
+            else { throw ex; }
+        }
+        catch (const std::out_of_range& ex)
+        {
+            if (omw::contains(ex.what(), "ip::")) { throw std::out_of_range(fnName.data()); }
+            else { throw ex; }
+        }
+        // other exceptions are not handled here
+    }
+
+    const auto prefixSizeStr = str.substr(slashPos + 1);
+
+    if (omw::isUInteger(prefixSizeStr) && (prefixSizeStr.size() <= 3))
+    {
+        const int prefixSize = std::stoi(prefixSizeStr);
+        this->setPrefixSize(prefixSize);
+    }
+    else { throw std::invalid_argument(fnName.data()); }
+
+    this->check();
+}
+
+ip::Addr6 ip::SubnetMask6::hostMask() const { return ~ip::Addr6(m_value.data()); }
+
+void ip::SubnetMask6::setPrefixSize(int size)
+{
+    constexpr std::string_view fnName = "ip::SubnetMask6::setPrefixSize";
+
+    if ((size < 0) || (size > (int)bit_count)) { throw std::out_of_range(fnName.data()); }
+
+    for (size_t i = 0; i < octet_count; ++i)
+    {
+        const int bits = size - (int)(i * 8);
+
+        if (bits >= 8) { m_value[i] = 0xFF; }
+        else if (bits <= 0) { m_value[i] = 0; }
+        else { m_value[i] = (uint8_t)(0xFF << (8 - bits)); }
+    }
+}
+
+uint8_t ip::SubnetMask6::prefixSize() const
+{
+    uint8_t r = 0;
+    static_assert(UINT8_MAX >= bit_count);
+
+    for (size_t i = 0; i < octet_count; ++i)
+    {
+        for (uint8_t mask = 0x80; mask; mask >>= 1)
+        {
+            if (m_value[i] & mask) { ++r; }
+        }
+    }
+
+    return r;
+}
+
+void ip::SubnetMask6::check() const noexcept(false)
+{
+    constexpr std::string_view fnName = "ip::SubnetMask6::check";
+
+    bool hostIdentifier = false;
+
+    for (size_t i = 0; i < octet_count; ++i)
+    {
+        for (uint8_t mask = 0x80; mask; mask >>= 1)
+        {
+            if (m_value[i] & mask)
+            {
+                if (hostIdentifier) { throw std::invalid_argument(fnName.data()); }
+            }
+            else { hostIdentifier = true; }
+        }
+    }
+}
+
+
+
+ip::Addr6 ip::operator~(const ip::Addr6& a)
+{
+    ip::Addr6::value_type r;
+    for (size_t i = 0; i < ip::Addr6::octet_count; ++i) { r[i] = (uint8_t)(~a.octet(i)); }
+    return ip::Addr6(r.data());
+}
+
+ip::Addr6 ip::operator&(const ip::Addr6& a, const ip::Addr6& b)
+{
+    ip::Addr6::value_type r;
+    for (size_t i = 0; i < ip::Addr6::octet_count; ++i) { r[i] = (a.octet(i) & b.octet(i)); }
+    return ip::Addr6(r.data());
+}
+
+ip::Addr6 ip::operator|(const ip::Addr6& a, const ip::Addr6& b)
+{
+    ip::Addr6::value_type r;
+    for (size_t i = 0; i < ip::Addr6::octet_count; ++i) { r[i] = (a.octet(i) | b.octet(i)); }
+    return ip::Addr6(r.data());
+}
+
+ip::Addr6 ip::operator^(const ip::Addr6& a, const ip::Addr6& b)
+{
+    ip::Addr6::value_type r;
+    for (size_t i = 0; i < ip::Addr6::octet_count; ++i) { r[i] = (a.octet(i) ^ b.octet(i)); }
+    return ip::Addr6(r.data());
+}
+
+
+
 //======================================================================================================================
 // this prevents certain code from getting optimised away
 
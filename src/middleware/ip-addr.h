@@ -7,6 +7,7 @@ copyright       GPL-3.0 - Copyright (c) 2025 Oliver Blaser
 #ifndef IG_MIDDLEWARE_IPADDR_H
 #define IG_MIDDLEWARE_IPADDR_H
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <string>
@@ -209,6 +210,148 @@ private:
     static const Addr4 broadcast; // doesn't make sense in subnet mask
 };
 
+class Addr6 : public Address
+{
+public:
+    using value_type = std::array<uint8_t, 16>;
+    static constexpr size_t octet_count = 16;
+    static constexpr size_t bit_count = octet_count * 8;
+
+    static const Addr6 null;     ///< all bits 0, `::`
+    static const Addr6 max;      ///< all bits 1
+    static const Addr6 allNodes; ///< link-local all nodes multicast address `ff02::1`
+
+public:
+    Addr6() noexcept(true)
+        : m_value{}
+    {}
+
+    /**
+     * Sixteen bytes are read from `data` (network byte order).
+     */
+    explicit Addr6(const uint8_t* data) noexcept(true)
+        : m_value{}
+    {
+        this->set(data);
+    }
+
+    Addr6(const char* str) noexcept(false)
+        : m_value{}
+    {
+        this->set(str);
+    }
+
+    Addr6(const std::string& str) noexcept(false)
+        : m_value{}
+    {
+        this->set(str);
+    }
+
+    virtual ~Addr6() {}
+
+    /**
+     * Expected format: RFC 4291 text representation, e.g. `fd00::1`, `fe80::2:3` or `::ffff:192.168.1.1`
+     */
+    virtual void set(const std::string& str) noexcept(false);
+
+    /**
+     * Sixteen bytes are read from `data` (network byte order).
+     */
+    virtual void set(const uint8_t* data) noexcept(false); // might throw in derived class
+
+    const value_type& value() const { return m_value; }
+    const uint8_t* data() const { return m_value.data(); }
+    uint8_t octet(size_t idx) const { return m_value[idx]; }
+    uint16_t hextet(size_t idx) const { return (uint16_t)(((uint16_t)m_value[2 * idx] << 8) | (uint16_t)m_value[2 * idx + 1]); }
+
+    bool isLinkLocal() const { return ((m_value[0] == 0xFE) && ((m_value[1] & 0xC0) == 0x80)); } ///< `fe80::/10`
+    bool isMulticast() const { return (m_value[0] == 0xFF); }                                     ///< `ff00::/8`
+
+    /**
+     * RFC 5952 canonical text representation.
+     */
+    virtual std::string toString() const;
+
+protected:
+    value_type m_value;
+};
+
+class SubnetMask6 : public Addr6,
+                    public SubnetMask
+{
+public:
+    static const SubnetMask6 null; ///< all bits 0
+    static const SubnetMask6 max;  ///< all bits 1
+
+public:
+    SubnetMask6() noexcept(true)
+        : Addr6()
+    {
+        m_value.fill(0xFF);
+    }
+
+    SubnetMask6(const ip::Addr6& mask) noexcept(false)
+        : Addr6(mask)
+    {
+        this->check();
+    }
+
+    explicit SubnetMask6(int prefixSize) noexcept(false)
+        : Addr6()
+    {
+        this->setPrefixSize(prefixSize);
+        this->check();
+    }
+
+    SubnetMask6(const char* str) noexcept(false)
+        : Addr6()
+    {
+        this->set(str);
+        this->check();
+    }
+
+    SubnetMask6(const std::string& str) noexcept(false)
+        : Addr6()
+    {
+        this->set(str);
+        this->check();
+    }
+
+    virtual ~SubnetMask6() {}
+
+    /**
+     * Expected format: `/X` or `<IP>/X` (where only `/X` is used, the format of IP is checked anyway)
+     */
+    virtual void set(const std::string& str) noexcept(false);
+
+    virtual void set(const uint8_t* data) noexcept(false)
+    {
+        Addr6::set(data);
+        this->check();
+    }
+
+    Addr6 hostMask() const;
+
+    /**
+     * See `ip::SubnetMask::setPrefixSize(int size)`.
+     */
+    virtual void setPrefixSize(int size);
+
+    /**
+     * See `ip::SubnetMask::prefixSize()`.
+     */
+    virtual uint8_t prefixSize() const;
+
+protected:
+    virtual void check() const noexcept(false);
+
+
+
+    // hiding
+private:
+    static const Addr6 allNodes; // doesn't make sense in subnet mask
+};
+
 
 
 static inline std::string cidrString(const ip::Address& addr, const ip::SubnetMask& subnetMask)
@@ -233,6 +376,18 @@ static inline ip::Addr4 operator&(const ip::Addr4& a, const ip::Addr4& b) { retu
 static inline ip::Addr4 operator|(const ip::Addr4& a, const ip::Addr4& b) { return ip::Addr4(a.value() | b.value()); }
 static inline ip::Addr4 operator^(const ip::Addr4& a, const ip::Addr4& b) { return ip::Addr4(a.value() ^ b.value()); }
 
+static inline bool operator==(const ip::Addr6& a, const ip::Addr6& b) { return (a.value() == b.value()); }
+static inline bool operator!=(const ip::Addr6& a, const ip::Addr6& b) { return !(a == b); }
+static inline bool operator<(const ip::Addr6& a, const ip::Addr6& b) { return (a.value() < b.value()); }
+static inline bool operator>(const ip::Addr6& a, const ip::Addr6& b) { return (b < a); }
+static inline bool operator<=(const ip::Addr6& a, const ip::Addr6& b) { return !(a > b); }
+static inline bool operator>=(const ip::Addr6& a, const ip::Addr6& b) { return !(a < b); }
+
+ip::Addr6 operator~(const ip::Addr6& a);
+ip::Addr6 operator&(const ip::Addr6& a, const ip::Addr6& b);
+ip::Addr6 operator|(const ip::Addr6& a, const ip::Addr6& b);
+ip::Addr6 operator^(const ip::Addr6& a, const ip::Addr6& b);
+
 // subnet mask operator overloads do not make sense, they are most likely going to throw because
 
 /// @}
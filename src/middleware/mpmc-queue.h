@@ -0,0 +1,132 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_MIDDLEWARE_MPMCQUEUE_H
+#define IG_MIDDLEWARE_MPMCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief Bounded lock-free multi-producer/multi-consumer FIFO.
+ *
+ * Ring buffer of cells with a sequence number each (D. Vyukov's bounded MPMC queue). A producer claims a slot by
+ * advancing the enqueue position and publishes the element by storing the sequence number, a consumer does the same on
+ * the dequeue side. Neither operation blocks, `push()` fails if the queue is full and `pop()` if it's empty.
+ *
+ * `T` has to be default constructible and move assignable.
+ */
+template <typename T> class MpmcQueue
+{
+public:
+    /**
+     * The capacity is rounded up to the next power of two.
+     */
+    explicit MpmcQueue(size_t capacity)
+        : m_mask(roundUp(capacity) - 1), m_cells(m_mask + 1), m_enqueuePos(0), m_dequeuePos(0)
+    {
+        for (size_t i = 0; i < m_cells.size(); ++i) { m_cells[i].seq.store(i, std::memory_order_relaxed); }
+    }
+
+    virtual ~MpmcQueue() {}
+
+    MpmcQueue(const MpmcQueue& other) = delete;
+    MpmcQueue& operator=(const MpmcQueue& other) = delete;
+
+    size_t capacity() const { return m_cells.size(); }
+
+    /**
+     * Returns `false` if the queue is full.
+     */
+    bool push(T value)
+    {
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+
+        while (true)
+        {
+            cell = &m_cells[pos & m_mask];
+            const size_t seq = cell->seq.load(std::memory_order_acquire);
+            const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+            if (diff == 0)
+            {
+                if (m_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) { break; }
+            }
+            else if (diff < 0) { return false; } // the consumers haven't freed the cell of the previous lap yet
+            else { pos = m_enqueuePos.load(std::memory_order_relaxed); }
+        }
+
+        cell->data = std::move(value);
+        cell->seq.store(pos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * Returns `false` if the queue is empty.
+     */
+    bool pop(T& value)
+    {
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+
+        while (true)
+        {
+            cell = &m_cells[pos & m_mask];
+            const size_t seq = cell->seq.load(std::memory_order_acquire);
+            const intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+
+            if (diff == 0)
+            {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) { break; }
+            }
+            else if (diff < 0) { return false; } // the producer hasn't published the cell yet
+            else { pos = m_dequeuePos.load(std::memory_order_relaxed); }
+        }
+
+        value = std::move(cell->data);
+        cell->data = T();
+        cell->seq.store(pos + m_mask + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * Exact only while no other thread pushes or pops.
+     */
+    bool empty() const { return (m_dequeuePos.load(std::memory_order_acquire) == m_enqueuePos.load(std::memory_order_acquire)); }
+
+private:
+    static constexpr size_t cache_line_size = 64;
+
+    struct Cell
+    {
+        std::atomic<size_t> seq;
+        T data;
+    };
+
+    static size_t roundUp(size_t capacity)
+    {
+        size_t n = 2;
+        while (n < capacity) { n <<= 1; }
+        return n;
+    }
+
+    const size_t m_mask;
+    std::vector<Cell> m_cells;
+
+    // on separate cache lines, so that producers and consumers don't invalidate each others positions
+    alignas(cache_line_size) std::atomic<size_t> m_enqueuePos;
+    alignas(cache_line_size) std::atomic<size_t> m_dequeuePos;
+};
+
+
+#endif // IG_MIDDLEWARE_MPMCQUEUE_H
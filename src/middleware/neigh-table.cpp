@@ -0,0 +1,183 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "cli.h"
+#include "ip-addr.h"
+#include "mac-addr.h"
+#include "neigh-table.h"
+
+#include <arpa/inet.h>
+#include <linux/neighbour.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+
+
+/**
+ * Sends a `RTM_GETNEIGH` dump request for `family` and calls `handler` for every message of the response.
+ */
+static int dumpFamily(uint8_t family, const std::function<void(const struct nlmsghdr* nh)>& handler);
+
+/**
+ * Returns the `ndmsg` if `nlmsg` is a `RTM_NEWNEIGH` message of address family `family`, `nullptr` otherwise. `dst` and
+ * `lladdr` point to the `NDA_DST` and `NDA_LLADDR` attributes, or are `nullptr` if they are missing.
+ */
+static const struct ndmsg* parseAttributes(const void* nlmsg, uint8_t family, size_t dstSize, const uint8_t*& dst, const uint8_t*& lladdr);
+
+
+
+bool neigh::Entry::valid() const { return ((m_state & (NUD_REACHABLE | NUD_STALE)) != 0); }
+bool neigh::Entry::failed() const { return ((m_state & NUD_FAILED) != 0); }
+bool neigh::Entry6::valid() const { return ((m_state & (NUD_REACHABLE | NUD_STALE | NUD_DELAY | NUD_PROBE)) != 0); }
+
+int neigh::dump(std::vector<neigh::Entry>& entries)
+{
+    return dumpFamily(AF_INET, [&entries](const struct nlmsghdr* nh) {
+        neigh::Entry entry;
+        if (neigh::parse(nh, entry) && entry.hasMac()) { entries.push_back(entry); }
+    });
+}
+
+int neigh::dump(std::vector<neigh::Entry6>& entries)
+{
+    return dumpFamily(AF_INET6, [&entries](const struct nlmsghdr* nh) {
+        neigh::Entry6 entry;
+        if (neigh::parse(nh, entry) && entry.hasMac()) { entries.push_back(entry); }
+    });
+}
+
+bool neigh::parse(const void* nlmsg, neigh::Entry& entry)
+{
+    const uint8_t* dst = nullptr;
+    const uint8_t* lladdr = nullptr;
+
+    const struct ndmsg* ndm = parseAttributes(nlmsg, AF_INET, ip::Addr4::octet_count, dst, lladdr);
+    if (!ndm || !dst) { return false; }
+
+    entry = neigh::Entry(ip::Addr4(dst[0], dst[1], dst[2], dst[3]), (lladdr ? mac::Addr(lladdr) : mac::Addr::null), ndm->ndm_ifindex, ndm->ndm_state);
+
+    return true;
+}
+
+bool neigh::parse(const void* nlmsg, neigh::Entry6& entry)
+{
+    const uint8_t* dst = nullptr;
+    const uint8_t* lladdr = nullptr;
+
+    const struct ndmsg* ndm = parseAttributes(nlmsg, AF_INET6, ip::Addr6::octet_count, dst, lladdr);
+    if (!ndm || !dst) { return false; }
+
+    entry = neigh::Entry6(ip::Addr6(dst), (lladdr ? mac::Addr(lladdr) : mac::Addr::null), ndm->ndm_ifindex, ndm->ndm_state);
+
+    return true;
+}
+
+
+
+int dumpFamily(uint8_t family, const std::function<void(const struct nlmsghdr* nh)>& handler)
+{
+    const int fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd < 0)
+    {
+        cli::printError("failed to open netlink socket", std::strerror(errno));
+        return -(__LINE__);
+    }
+
+    struct
+    {
+        struct nlmsghdr nh;
+        struct ndmsg ndm;
+    } req;
+
+    std::memset(&req, 0, sizeof(req));
+    req.nh.nlmsg_len = NLMSG_LENGTH(sizeof(struct ndmsg));
+    req.nh.nlmsg_type = RTM_GETNEIGH;
+    req.nh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    req.nh.nlmsg_seq = 1;
+    req.ndm.ndm_family = family;
+
+    if (send(fd, &req, req.nh.nlmsg_len, 0) < 0)
+    {
+        cli::printError("failed to send RTM_GETNEIGH", std::strerror(errno));
+        close(fd);
+        return -(__LINE__);
+    }
+
+    int r = 0;
+    bool done = false;
+    alignas(struct nlmsghdr) uint8_t buffer[32 * 1024];
+
+    while (!done)
+    {
+        const ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n < 0)
+        {
+            if (errno == EINTR) { continue; }
+
+            cli::printError("failed to receive the neighbour table", std::strerror(errno));
+            r = -(__LINE__);
+            break;
+        }
+
+        int len = (int)n;
+        for (const struct nlmsghdr* nh = (const struct nlmsghdr*)buffer; NLMSG_OK(nh, len); nh = NLMSG_NEXT(nh, len))
+        {
+            if (nh->nlmsg_type == NLMSG_DONE)
+            {
+                done = true;
+                break;
+            }
+            else if (nh->nlmsg_type == NLMSG_ERROR)
+            {
+                const auto* err = (const struct nlmsgerr*)NLMSG_DATA(nh);
+                cli::printError("RTM_GETNEIGH failed", std::strerror(-(err->error)));
+                r = -(__LINE__);
+                done = true;
+                break;
+            }
+
+            handler(nh);
+        }
+
+        if (n == 0) { done = true; }
+    }
+
+    close(fd);
+
+    return r;
+}
+
+const struct ndmsg* parseAttributes(const void* nlmsg, uint8_t family, size_t dstSize, const uint8_t*& dst, const uint8_t*& lladdr)
+{
+    const auto* nh = (const struct nlmsghdr*)nlmsg;
+
+    if ((nh->nlmsg_type != RTM_NEWNEIGH) || (nh->nlmsg_len < NLMSG_LENGTH(sizeof(struct ndmsg)))) { return nullptr; }
+
+    const auto* ndm = (const struct ndmsg*)NLMSG_DATA(nh);
+    if (ndm->ndm_family != family) { return nullptr; }
+
+    dst = nullptr;
+    lladdr = nullptr;
+
+    int len = (int)NLMSG_PAYLOAD(nh, sizeof(struct ndmsg));
+    for (const struct rtattr* rta = (const struct rtattr*)((const uint8_t*)ndm + NLMSG_ALIGN(sizeof(struct ndmsg))); RTA_OK(rta, len);
+         rta = RTA_NEXT(rta, len))
+    {
+        if ((rta->rta_type == NDA_DST) && (RTA_PAYLOAD(rta) == dstSize)) { dst = (const uint8_t*)RTA_DATA(rta); }
+        else if ((rta->rta_type == NDA_LLADDR) && (RTA_PAYLOAD(rta) == mac::Addr::size())) { lladdr = (const uint8_t*)RTA_DATA(rta); }
+    }
+
+    return ndm;
+}
@@ -0,0 +1,119 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_MIDDLEWARE_NEIGHTABLE_H
+#define IG_MIDDLEWARE_NEIGHTABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "middleware/ip-addr.h"
+#include "middleware/mac-addr.h"
+
+
+/**
+ * @brief Kernel neighbour table (ARP cache) access via rtnetlink.
+ */
+namespace neigh {
+
+class Entry
+{
+public:
+    Entry()
+        : m_ip(), m_mac(), m_ifindex(0), m_state(0)
+    {}
+
+    Entry(const ip::Addr4& ip, const mac::Addr& mac, int ifindex, uint16_t state)
+        : m_ip(ip), m_mac(mac), m_ifindex(ifindex), m_state(state)
+    {}
+
+    virtual ~Entry() {}
+
+    const ip::Addr4& ip() const { return m_ip; }
+    const mac::Addr& mac() const { return m_mac; }
+    int ifindex() const { return m_ifindex; }
+    uint16_t state() const { return m_state; } ///< `NUD_*` flags
+
+    /**
+     * Returns `true` if the entry is in `REACHABLE` or `STALE` state, meaning the host has answered recently.
+     */
+    bool valid() const;
+
+    /**
+     * Returns `true` if the address resolution has failed.
+     */
+    bool failed() const;
+
+    bool hasMac() const { return (m_mac != mac::Addr::null); }
+
+private:
+    ip::Addr4 m_ip;
+    mac::Addr m_mac;
+    int m_ifindex;
+    uint16_t m_state;
+};
+
+/**
+ * @brief IPv6 neighbour cache entry.
+ */
+class Entry6
+{
+public:
+    Entry6()
+        : m_ip(), m_mac(), m_ifindex(0), m_state(0)
+    {}
+
+    Entry6(const ip::Addr6& ip, const mac::Addr& mac, int ifindex, uint16_t state)
+        : m_ip(ip), m_mac(mac), m_ifindex(ifindex), m_state(state)
+    {}
+
+    virtual ~Entry6() {}
+
+    const ip::Addr6& ip() const { return m_ip; }
+    const mac::Addr& mac() const { return m_mac; }
+    int ifindex() const { return m_ifindex; }
+    uint16_t state() const { return m_state; } ///< `NUD_*` flags
+
+    /**
+     * See `neigh::Entry::valid()`.
+     */
+    bool valid() const;
+
+    bool hasMac() const { return (m_mac != mac::Addr::null); }
+
+private:
+    ip::Addr6 m_ip;
+    mac::Addr m_mac;
+    int m_ifindex;
+    uint16_t m_state;
+};
+
+/**
+ * Dumps the IPv4 neighbour table with a `RTM_GETNEIGH` request. Entries without a link layer address are omitted.
+ */
+int dump(std::vector<neigh::Entry>& entries);
+
+/**
+ * Dumps the IPv6 neighbour cache. Entries without a link layer address are omitted.
+ */
+int dump(std::vector<neigh::Entry6>& entries);
+
+/**
+ * Parses a `RTM_NEWNEIGH` message. Returns `false` if the message is not an IPv4 entry. Entries in `INCOMPLETE` or
+ * `FAILED` state have no link layer address, `mac()` is null then.
+ */
+bool parse(const void* nlmsg, neigh::Entry& entry);
+
+/**
+ * Same as `neigh::parse()` for IPv6 entries.
+ */
+bool parse(const void* nlmsg, neigh::Entry6& entry);
+
+} // namespace neigh
+
+
+#endif // IG_MIDDLEWARE_NEIGHTABLE_H
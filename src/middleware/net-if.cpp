@@ -0,0 +1,137 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "cli.h"
+#include "ip-addr.h"
+#include "mac-addr.h"
+#include "net-if.h"
+
+#include <arpa/inet.h>
+#include <ifaddrs.h>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+
+
+
+static ip::Addr4 toAddr4(const struct sockaddr* sa) { return ip::Addr4(ntohl(((const struct sockaddr_in*)sa)->sin_addr.s_addr)); }
+static ip::Addr6 toAddr6(const struct sockaddr* sa) { return ip::Addr6(((const struct sockaddr_in6*)sa)->sin6_addr.s6_addr); }
+
+/**
+ * Returns the `AF_PACKET` entry of the interface, which holds the link layer address, or `nullptr` if there is none.
+ */
+static const struct sockaddr_ll* findLinkLayer(const struct ifaddrs* ifaList, const char* name);
+
+/**
+ * Returns `true` if the entry is an up, non loopback, ARP/ND capable interface of the address family `family`.
+ */
+static bool usable(const struct ifaddrs* ifa, int family);
+
+
+
+std::vector<netif::Interface> netif::getInterfaces()
+{
+    std::vector<netif::Interface> interfaces;
+
+    struct ifaddrs* ifaList = nullptr;
+
+    if (getifaddrs(&ifaList) != 0)
+    {
+        cli::printError("getifaddrs() failed", std::strerror(errno));
+        return interfaces;
+    }
+
+    for (const struct ifaddrs* ifa = ifaList; ifa; ifa = ifa->ifa_next)
+    {
+        if (!usable(ifa, AF_INET)) { continue; }
+
+        const struct sockaddr_ll* sll = findLinkLayer(ifaList, ifa->ifa_name);
+        if (!sll) { continue; }
+
+        try
+        {
+            interfaces.push_back(netif::Interface(ifa->ifa_name, sll->sll_ifindex, mac::Addr(sll->sll_addr), toAddr4(ifa->ifa_addr),
+                                                  ip::SubnetMask4(toAddr4(ifa->ifa_netmask))));
+        }
+        catch (const std::exception& ex)
+        {
+            cli::printWarning("ignoring interface " + std::string(ifa->ifa_name) + ": " + ex.what());
+        }
+    }
+
+    freeifaddrs(ifaList);
+
+    return interfaces;
+}
+
+std::vector<netif::Interface6> netif::getInterfaces6()
+{
+    std::vector<netif::Interface6> interfaces;
+
+    struct ifaddrs* ifaList = nullptr;
+
+    if (getifaddrs(&ifaList) != 0)
+    {
+        cli::printError("getifaddrs() failed", std::strerror(errno));
+        return interfaces;
+    }
+
+    for (const struct ifaddrs* ifa = ifaList; ifa; ifa = ifa->ifa_next)
+    {
+        if (!usable(ifa, AF_INET6)) { continue; }
+
+        const struct sockaddr_ll* sll = findLinkLayer(ifaList, ifa->ifa_name);
+        if (!sll) { continue; }
+
+        try
+        {
+            interfaces.push_back(netif::Interface6(ifa->ifa_name, sll->sll_ifindex, mac::Addr(sll->sll_addr), toAddr6(ifa->ifa_addr),
+                                                   ip::SubnetMask6(toAddr6(ifa->ifa_netmask))));
+        }
+        catch (const std::exception& ex)
+        {
+            cli::printWarning("ignoring interface " + std::string(ifa->ifa_name) + ": " + ex.what());
+        }
+    }
+
+    freeifaddrs(ifaList);
+
+    return interfaces;
+}
+
+
+
+const struct sockaddr_ll* findLinkLayer(const struct ifaddrs* ifaList, const char* name)
+{
+    // the link layer address is listed in a separate AF_PACKET entry with the same name
+    for (const struct ifaddrs* ifa = ifaList; ifa; ifa = ifa->ifa_next)
+    {
+        if (ifa->ifa_addr && (ifa->ifa_addr->sa_family == AF_PACKET) && (std::strcmp(ifa->ifa_name, name) == 0))
+        {
+            const auto* sll = (const struct sockaddr_ll*)(ifa->ifa_addr);
+            return (sll->sll_halen == mac::Addr::size() ? sll : nullptr);
+        }
+    }
+
+    return nullptr;
+}
+
+bool usable(const struct ifaddrs* ifa, int family)
+{
+    if (!ifa->ifa_addr || !ifa->ifa_netmask || (ifa->ifa_addr->sa_family != family)) { return false; }
+    if (!(ifa->ifa_flags & IFF_UP) || (ifa->ifa_flags & (IFF_LOOPBACK | IFF_NOARP))) { return false; }
+
+    return true;
+}
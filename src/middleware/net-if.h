@@ -0,0 +1,104 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_MIDDLEWARE_NETIF_H
+#define IG_MIDDLEWARE_NETIF_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "middleware/ip-addr.h"
+#include "middleware/mac-addr.h"
+
+
+namespace netif {
+
+/**
+ * @brief IPv4 configuration of a local network interface.
+ */
+class Interface
+{
+public:
+    Interface()
+        : m_name(), m_index(0), m_mac(), m_ip(), m_mask(ip::SubnetMask4::max)
+    {}
+
+    Interface(const std::string& name, int index, const mac::Addr& mac, const ip::Addr4& ip, const ip::SubnetMask4& mask)
+        : m_name(name), m_index(index), m_mac(mac), m_ip(ip), m_mask(mask)
+    {}
+
+    virtual ~Interface() {}
+
+    const std::string& name() const { return m_name; }
+    int index() const { return m_index; }
+    const mac::Addr& mac() const { return m_mac; }
+    const ip::Addr4& ip() const { return m_ip; }
+    const ip::SubnetMask4& mask() const { return m_mask; }
+
+    ip::Addr4 network() const { return (m_ip & m_mask); }
+
+    /**
+     * Returns `true` if `addr` is on the same subnet as the interface.
+     */
+    bool contains(const ip::Addr4& addr) const { return ((addr & m_mask) == this->network()); }
+
+private:
+    std::string m_name;
+    int m_index;
+    mac::Addr m_mac;
+    ip::Addr4 m_ip;
+    ip::SubnetMask4 m_mask;
+};
+
+/**
+ * @brief IPv6 configuration of a local network interface.
+ */
+class Interface6
+{
+public:
+    Interface6()
+        : m_name(), m_index(0), m_mac(), m_ip(), m_mask(ip::SubnetMask6::max)
+    {}
+
+    Interface6(const std::string& name, int index, const mac::Addr& mac, const ip::Addr6& ip, const ip::SubnetMask6& mask)
+        : m_name(name), m_index(index), m_mac(mac), m_ip(ip), m_mask(mask)
+    {}
+
+    virtual ~Interface6() {}
+
+    const std::string& name() const { return m_name; }
+    int index() const { return m_index; }
+    const mac::Addr& mac() const { return m_mac; }
+    const ip::Addr6& ip() const { return m_ip; }
+    const ip::SubnetMask6& mask() const { return m_mask; }
+
+    ip::Addr6 network() const { return (m_ip & m_mask); }
+
+private:
+    std::string m_name;
+    int m_index;
+    mac::Addr m_mac;
+    ip::Addr6 m_ip;
+    ip::SubnetMask6 m_mask;
+};
+
+/**
+ * Returns all interfaces which are up, are not loopback and have an IPv4 address and a MAC address assigned. An
+ * interface with multiple IPv4 addresses is listed once per address.
+ */
+std::vector<netif::Interface> getInterfaces();
+
+/**
+ * Same as `netif::getInterfaces()` for IPv6 addresses, including the link-local ones.
+ */
+std::vector<netif::Interface6> getInterfaces6();
+
+} // namespace netif
+
+
+#endif // IG_MIDDLEWARE_NETIF_H
@@ -0,0 +1,105 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "cli.h"
+#include "pacer.h"
+
+#include <omw/clock.h>
+
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+
+using omw::clock::timepoint_t;
+
+
+
+Pacer::Pacer()
+    : m_rate(0), m_capacity(0), m_credit(0), m_lastRefill(0), m_fd(-1)
+{}
+
+Pacer::~Pacer() { this->close(); }
+
+int Pacer::open(uint32_t rate, size_t burst)
+{
+    this->close();
+
+    m_rate = rate;
+    m_capacity = (int64_t)(burst > 0 ? burst : 1) * token;
+    m_credit = m_capacity;
+    m_lastRefill = omw::clock::now();
+
+    if (m_rate == 0) { return 0; }
+
+    m_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (m_fd < 0)
+    {
+        cli::printError("failed to create pacing timer", std::strerror(errno));
+        m_rate = 0;
+        return -(__LINE__);
+    }
+
+    return 0;
+}
+
+bool Pacer::ready(timepoint_t now)
+{
+    if (m_rate == 0) { return true; }
+
+    if (now > m_lastRefill)
+    {
+        m_credit += (now - m_lastRefill) * (int64_t)m_rate;
+        if (m_credit > m_capacity) { m_credit = m_capacity; }
+        m_lastRefill = now;
+    }
+
+    return (m_credit >= token);
+}
+
+void Pacer::consume()
+{
+    if (m_rate > 0) { m_credit -= token; }
+}
+
+void Pacer::arm(timepoint_t now)
+{
+    if (m_fd < 0) { return; }
+
+    (void)this->ready(now);
+
+    const int64_t missing = (m_credit < token ? token - m_credit : 0);
+    const int64_t delay_us = (missing + m_rate - 1) / m_rate;
+
+    struct itimerspec its;
+    std::memset(&its, 0, sizeof(its));
+    its.it_value.tv_sec = (time_t)(delay_us / 1000000);
+    its.it_value.tv_nsec = (long)((delay_us % 1000000) * 1000);
+    if ((its.it_value.tv_sec == 0) && (its.it_value.tv_nsec == 0)) { its.it_value.tv_nsec = 1; } // zero would disarm it
+
+    if (timerfd_settime(m_fd, 0, &its, nullptr) != 0) { cli::printError("failed to arm pacing timer", std::strerror(errno)); }
+}
+
+void Pacer::acknowledge()
+{
+    if (m_fd < 0) { return; }
+
+    uint64_t expirations;
+    (void)read(m_fd, &expirations, sizeof(expirations));
+}
+
+void Pacer::close()
+{
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
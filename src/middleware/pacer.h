@@ -0,0 +1,74 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_MIDDLEWARE_PACER_H
+#define IG_MIDDLEWARE_PACER_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <omw/clock.h>
+
+
+/**
+ * @brief Token bucket which limits the packet rate, with a `timerfd` to wait for the next token.
+ *
+ * The bucket holds up to `burst` tokens and is refilled with `rate` tokens per second. Sending a packet takes one
+ * token. The timer is meant to be added to the `poll()` set of the sender, it becomes readable as soon as the next
+ * token is available, with sub-millisecond accuracy.
+ */
+class Pacer
+{
+public:
+    Pacer();
+    virtual ~Pacer();
+
+    Pacer(const Pacer& other) = delete;
+    Pacer& operator=(const Pacer& other) = delete;
+
+    /**
+     * `rate` is in packets per second, 0 disables pacing and no timer is created.
+     */
+    int open(uint32_t rate, size_t burst);
+
+    bool enabled() const { return (m_rate > 0); }
+    int fd() const { return m_fd; }
+
+    /**
+     * Refills the bucket and returns `true` if a token is available.
+     */
+    bool ready(omw::clock::timepoint_t now);
+
+    /**
+     * Takes a token. May be called on an empty bucket for packets which can't be held back (retransmissions), the debt is
+     * paid by delaying the following packets, so the average rate is kept.
+     */
+    void consume();
+
+    /**
+     * Arms the timer to expire when the next token is available.
+     */
+    void arm(omw::clock::timepoint_t now);
+
+    /**
+     * Reads the expiration count from the timer, so that it isn't readable anymore.
+     */
+    void acknowledge();
+
+private:
+    static constexpr int64_t token = 1000000; // credit of one token, a rate of 1pps adds 1 credit per us
+
+    uint32_t m_rate;
+    int64_t m_capacity;
+    int64_t m_credit;
+    omw::clock::timepoint_t m_lastRefill;
+    int m_fd;
+
+    void close();
+};
+
+
+#endif // IG_MIDDLEWARE_PACER_H
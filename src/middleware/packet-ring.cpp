@@ -0,0 +1,203 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "cli.h"
+#include "packet-ring.h"
+
+#include <omw/clock.h>
+
+#include <arpa/inet.h>
+#include <linux/if_packet.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+
+using omw::clock::timepoint_t;
+
+
+
+static inline uint32_t loadStatus(const volatile uint32_t* status) { return __atomic_load_n(status, __ATOMIC_ACQUIRE); }
+static inline void storeStatus(volatile uint32_t* status, uint32_t value) { __atomic_store_n(status, value, __ATOMIC_RELEASE); }
+
+static timepoint_t realtime_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return ((timepoint_t)ts.tv_sec * 1000000 + (timepoint_t)ts.tv_nsec / 1000);
+}
+
+
+
+PacketRing::PacketRing()
+    : m_fd(-1), m_map(nullptr), m_mapSize(0), m_tx(nullptr), m_txFrameCount(0), m_rxBlock(0)
+{}
+
+PacketRing::~PacketRing() { this->close(); }
+
+int PacketRing::open(int ifindex, uint16_t protocol)
+{
+    static_assert(tx_data_offset == TPACKET_ALIGN(sizeof(struct tpacket3_hdr)));
+    static_assert((tx_frame_size % TPACKET_ALIGNMENT) == 0);
+
+    this->close();
+
+    m_fd = socket(AF_PACKET, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, htons(protocol));
+    if (m_fd < 0)
+    {
+        cli::printError("failed to open AF_PACKET socket", std::strerror(errno));
+        return -(__LINE__);
+    }
+
+    const int version = TPACKET_V3;
+    if (setsockopt(m_fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) != 0)
+    {
+        cli::printError("TPACKET_V3 is not supported", std::strerror(errno));
+        return -(__LINE__);
+    }
+
+    // own frames are of no interest, not supported before Linux 4.20
+    const int ignoreOutgoing = 1;
+    (void)setsockopt(m_fd, SOL_PACKET, PACKET_IGNORE_OUTGOING, &ignoreOutgoing, sizeof(ignoreOutgoing));
+
+    struct tpacket_req3 rxReq;
+    std::memset(&rxReq, 0, sizeof(rxReq));
+    rxReq.tp_block_size = rx_block_size;
+    rxReq.tp_block_nr = rx_block_count;
+    rxReq.tp_frame_size = TPACKET_ALIGNMENT << 7; // not used by V3 RX, but checked by the kernel
+    rxReq.tp_frame_nr = (rx_block_size * rx_block_count) / rxReq.tp_frame_size;
+    rxReq.tp_retire_blk_tov = rx_block_timeout_ms;
+
+    struct tpacket_req3 txReq;
+    std::memset(&txReq, 0, sizeof(txReq));
+    txReq.tp_block_size = tx_block_size;
+    txReq.tp_block_nr = tx_block_count;
+    txReq.tp_frame_size = tx_frame_size;
+    txReq.tp_frame_nr = (tx_block_size * tx_block_count) / tx_frame_size;
+
+    if ((setsockopt(m_fd, SOL_PACKET, PACKET_RX_RING, &rxReq, sizeof(rxReq)) != 0) ||
+        (setsockopt(m_fd, SOL_PACKET, PACKET_TX_RING, &txReq, sizeof(txReq)) != 0))
+    {
+        cli::printError("failed to set up the packet rings", std::strerror(errno));
+        return -(__LINE__);
+    }
+
+    // the RX ring is mapped first, followed by the TX ring
+    const size_t rxSize = rx_block_size * rx_block_count;
+    const size_t txSize = tx_block_size * tx_block_count;
+
+    void* const map = mmap(nullptr, rxSize + txSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (map == MAP_FAILED)
+    {
+        cli::printError("failed to map the packet rings", std::strerror(errno));
+        return -(__LINE__);
+    }
+
+    m_map = (uint8_t*)map;
+    m_mapSize = rxSize + txSize;
+    m_tx = m_map + rxSize;
+    m_txFrameCount = txReq.tp_frame_nr;
+    m_rxBlock = 0;
+
+    struct sockaddr_ll sll;
+    std::memset(&sll, 0, sizeof(sll));
+    sll.sll_family = AF_PACKET;
+    sll.sll_protocol = htons(protocol);
+    sll.sll_ifindex = ifindex;
+
+    if (bind(m_fd, (const struct sockaddr*)(&sll), sizeof(sll)) != 0)
+    {
+        cli::printError("failed to bind AF_PACKET socket", std::strerror(errno));
+        return -(__LINE__);
+    }
+
+    return 0;
+}
+
+uint8_t* PacketRing::txData(size_t idx) { return (m_tx + idx * tx_frame_size + tx_data_offset); }
+
+bool PacketRing::txAvailable(size_t idx) const
+{
+    const auto* hdr = (const struct tpacket3_hdr*)(m_tx + idx * tx_frame_size);
+    const uint32_t status = loadStatus(&hdr->tp_status);
+    return ((status == TP_STATUS_AVAILABLE) || (status == TP_STATUS_WRONG_FORMAT));
+}
+
+void PacketRing::txSubmit(size_t idx, size_t size)
+{
+    auto* hdr = (struct tpacket3_hdr*)(m_tx + idx * tx_frame_size);
+    hdr->tp_next_offset = 0;
+    hdr->tp_len = (uint32_t)size;
+    hdr->tp_snaplen = (uint32_t)size;
+    storeStatus(&hdr->tp_status, TP_STATUS_SEND_REQUEST);
+}
+
+int PacketRing::flush()
+{
+    if (::send(m_fd, nullptr, 0, MSG_DONTWAIT) < 0)
+    {
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == ENOBUFS)) { return 0; } // frames stay in the ring
+
+        cli::printError("failed to flush the TX ring", std::strerror(errno));
+        return -(__LINE__);
+    }
+
+    return 0;
+}
+
+void PacketRing::receive(const frame_handler& handler)
+{
+    const timepoint_t now = omw::clock::now();
+    const timepoint_t now_real = realtime_us();
+
+    while (true)
+    {
+        auto* block = (struct tpacket_block_desc*)(m_map + m_rxBlock * rx_block_size);
+
+        if ((loadStatus(&block->hdr.bh1.block_status) & TP_STATUS_USER) == 0) { break; }
+
+        const uint32_t n = block->hdr.bh1.num_pkts;
+        const auto* pkt = (const struct tpacket3_hdr*)((const uint8_t*)block + block->hdr.bh1.offset_to_first_pkt);
+
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            // convert the kernel timestamp to the steady clock
+            const timepoint_t pktTime = (timepoint_t)pkt->tp_sec * 1000000 + (timepoint_t)pkt->tp_nsec / 1000;
+            const timepoint_t age = (now_real > pktTime ? now_real - pktTime : 0);
+
+            handler((const uint8_t*)pkt + pkt->tp_mac, pkt->tp_snaplen, now - age);
+
+            pkt = (const struct tpacket3_hdr*)((const uint8_t*)pkt + pkt->tp_next_offset);
+        }
+
+        storeStatus(&block->hdr.bh1.block_status, TP_STATUS_KERNEL);
+        m_rxBlock = (m_rxBlock + 1) % rx_block_count;
+    }
+}
+
+void PacketRing::close()
+{
+    if (m_map)
+    {
+        munmap(m_map, m_mapSize);
+        m_map = nullptr;
+        m_mapSize = 0;
+        m_tx = nullptr;
+        m_txFrameCount = 0;
+    }
+
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
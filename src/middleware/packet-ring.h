@@ -0,0 +1,94 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_MIDDLEWARE_PACKETRING_H
+#define IG_MIDDLEWARE_PACKETRING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include <omw/clock.h>
+
+
+/**
+ * @brief `AF_PACKET` socket with memory mapped `TPACKET_V3` RX and TX rings (PACKET_MMAP).
+ *
+ * Frames are written to and read from the rings in place, the only syscalls needed are `poll()` and the `send()` which
+ * tells the kernel to transmit all submitted TX frames.
+ */
+class PacketRing
+{
+public:
+    /**
+     * `rxTime` is the time the kernel has received the frame, in the time base of `omw::clock::now()`.
+     */
+    using frame_handler = std::function<void(const uint8_t* frame, size_t size, omw::clock::timepoint_t rxTime)>;
+
+public:
+    PacketRing();
+    virtual ~PacketRing();
+
+    PacketRing(const PacketRing& other) = delete;
+    PacketRing& operator=(const PacketRing& other) = delete;
+
+    /**
+     * Opens the socket and binds it to the interface. `protocol` is the ethertype in host byte order.
+     */
+    int open(int ifindex, uint16_t protocol);
+
+    int fd() const { return m_fd; }
+
+    size_t txFrameCount() const { return m_txFrameCount; }
+    static constexpr size_t txFrameSize() { return tx_frame_size - tx_data_offset; }
+
+    /**
+     * Returns a pointer to the data of TX frame `idx`. The data stays in the ring after transmission, so a frame can be
+     * templated once and only the changing bytes have to be written before it's submitted again.
+     */
+    uint8_t* txData(size_t idx);
+
+    /**
+     * Returns `true` if TX frame `idx` is owned by user space.
+     */
+    bool txAvailable(size_t idx) const;
+
+    /**
+     * Hands TX frame `idx` with `size` bytes of data over to the kernel. The frame is sent on the next call to `flush()`.
+     */
+    void txSubmit(size_t idx, size_t size);
+
+    /**
+     * Transmits all submitted TX frames without blocking.
+     */
+    int flush();
+
+    /**
+     * Calls `handler` for every frame in the RX blocks which are ready, and returns the blocks to the kernel.
+     */
+    void receive(const frame_handler& handler);
+
+private:
+    static constexpr size_t rx_block_size = 1 << 16;
+    static constexpr size_t rx_block_count = 64;
+    static constexpr unsigned int rx_block_timeout_ms = 1;
+    static constexpr size_t tx_block_size = 1 << 16;
+    static constexpr size_t tx_block_count = 16;
+    static constexpr size_t tx_frame_size = 128;
+    static constexpr size_t tx_data_offset = 48; // TPACKET_ALIGN(sizeof(struct tpacket3_hdr)), checked in the .cpp
+
+    int m_fd;
+    uint8_t* m_map;
+    size_t m_mapSize;
+    uint8_t* m_tx;
+    size_t m_txFrameCount;
+    size_t m_rxBlock;
+
+    void close();
+};
+
+
+#endif // IG_MIDDLEWARE_PACKETRING_H
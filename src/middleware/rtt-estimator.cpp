@@ -0,0 +1,53 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "rtt-estimator.h"
+
+#include <omw/clock.h>
+
+
+using omw::clock::timepoint_t;
+
+
+
+void RttEstimator::addSample(timepoint_t rtt)
+{
+    if (rtt < 0) { rtt = 0; }
+
+    if (m_sampleCount == 0)
+    {
+        m_srtt = rtt;
+        m_rttvar = rtt / 2;
+    }
+    else
+    {
+        const timepoint_t err = (m_srtt > rtt ? m_srtt - rtt : rtt - m_srtt);
+
+        // beta = 1/4, alpha = 1/8
+        m_rttvar = (3 * m_rttvar + err) / 4;
+        m_srtt = (7 * m_srtt + rtt) / 8;
+    }
+
+    ++m_sampleCount;
+
+    m_rto = std::clamp<timepoint_t>(m_srtt + 4 * m_rttvar, m_minRto, m_maxRto);
+}
+
+timepoint_t RttEstimator::rto(int n) const
+{
+    timepoint_t r = m_rto;
+
+    // the initial timeout is conservative already
+    if (m_sampleCount == 0) { return r; }
+
+    for (int i = 0; (i < n) && (r < m_maxRto); ++i) { r *= 2; }
+
+    return std::min(r, m_maxRto);
+}
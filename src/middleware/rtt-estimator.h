@@ -0,0 +1,61 @@
+/*
+author          Oliver Blaser
+date            16.10.2026
+copyright       GPL-3.0 - Copyright (c) 2026 Oliver Blaser
+*/
+
+#ifndef IG_MIDDLEWARE_RTTESTIMATOR_H
+#define IG_MIDDLEWARE_RTTESTIMATOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <omw/clock.h>
+
+
+/**
+ * @brief Smoothed round trip time and variance estimator (Jacobson/Karels, as in RFC 6298).
+ *
+ * All times are in microseconds.
+ */
+class RttEstimator
+{
+public:
+    RttEstimator(omw::clock::timepoint_t initialRto, omw::clock::timepoint_t minRto, omw::clock::timepoint_t maxRto)
+        : m_srtt(0), m_rttvar(0), m_rto(initialRto), m_minRto(minRto), m_maxRto(maxRto), m_sampleCount(0)
+    {}
+
+    virtual ~RttEstimator() {}
+
+    /**
+     * Feeds a measured round trip time into the estimator. Measurements of retransmitted requests are ambiguous and
+     * must not be added (Karn's algorithm).
+     */
+    void addSample(omw::clock::timepoint_t rtt);
+
+    omw::clock::timepoint_t srtt() const { return m_srtt; }
+    omw::clock::timepoint_t rttvar() const { return m_rttvar; }
+    size_t sampleCount() const { return m_sampleCount; }
+
+    /**
+     * Retransmission timeout, `srtt + 4 * rttvar` clamped to the limits. The timeout passed to the constructor is
+     * returned until the first sample has been added.
+     */
+    omw::clock::timepoint_t rto() const { return m_rto; }
+
+    /**
+     * Retransmission timeout after `n` unanswered retransmissions, doubled each time once a sample has been added.
+     */
+    omw::clock::timepoint_t rto(int n) const;
+
+private:
+    omw::clock::timepoint_t m_srtt;
+    omw::clock::timepoint_t m_rttvar;
+    omw::clock::timepoint_t m_rto;
+    omw::clock::timepoint_t m_minRto;
+    omw::clock::timepoint_t m_maxRto;
+    size_t m_sampleCount;
+};
+
+
+#endif // IG_MIDDLEWARE_RTTESTIMATOR_H